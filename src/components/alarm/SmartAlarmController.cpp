@@ -189,9 +189,14 @@ SmartAlarmController::SleepPhase SmartAlarmController::AnalyzeSleepPhase() {
   // Need at least 5 minutes of data for meaningful analysis
   static constexpr uint16_t analysisWindow = 10;
   static constexpr uint16_t minEntries = 5;
+  // Measurements are logged at most every 30 s: only look at the last analysisWindow * 30 s, older entries
+  // are left from before a gap in the measurements
+  static constexpr uint32_t analysisDuration = analysisWindow * 30;
 
+  const auto now = static_cast<uint32_t>(std::chrono::system_clock::to_time_t(
+    std::chrono::time_point_cast<std::chrono::system_clock::duration>(dateTime.CurrentDateTime())));
   HeartRateLogger::Entry entries[analysisWindow];
-  uint16_t count = hrLogger.GetRecentEntries(entries, analysisWindow);
+  uint16_t count = hrLogger.GetEntries(now + 1 - analysisDuration, now + 1, entries, analysisWindow);
 
   if (count < minEntries) {
     return SleepPhase::Unknown;
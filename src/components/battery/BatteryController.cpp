@@ -16,6 +16,9 @@ Battery::Battery() {
 }
 
 void Battery::ReadPowerState() {
+  const bool wasCharging = IsCharging();
+  const bool wasPowerPresent = isPowerPresent;
+
   isCharging = (nrf_gpio_pin_read(PinMap::Charging) == 0);
   isPowerPresent = (nrf_gpio_pin_read(PinMap::PowerPresent) == 0);
 
@@ -24,6 +27,10 @@ void Battery::ReadPowerState() {
   } else if (!isPowerPresent) {
     isFull = false;
   }
+
+  if (wasCharging != IsCharging() || wasPowerPresent != isPowerPresent) {
+    changeNotifier.Notify();
+  }
 }
 
 void Battery::MeasureVoltage() {
@@ -85,6 +92,7 @@ void Battery::SaadcEventHandler(nrfx_saadc_evt_t const* p_event) {
       firstMeasurement = false;
       percentRemaining = newPercent;
       systemTask->PushMessage(System::Messages::BatteryPercentageUpdated);
+      changeNotifier.Notify();
     }
 
     nrfx_saadc_uninit();
@@ -2,6 +2,7 @@
 #include <cstdint>
 #include <drivers/include/nrfx_saadc.h>
 #include <systemtask/SystemTask.h>
+#include "utility/DataChangeNotifier.h"
 
 namespace Pinetime {
   namespace Controllers {
@@ -14,6 +15,10 @@ namespace Pinetime {
       void MeasureVoltage();
       void Register(System::SystemTask* systemTask);
 
+      void Subscribe(Utility::DataChangeListener* listener) {
+        changeNotifier.Subscribe(listener);
+      }
+
       uint8_t PercentRemaining() const {
         return percentRemaining;
       }
@@ -53,6 +58,7 @@ namespace Pinetime {
       bool isReading = false;
 
       Pinetime::System::SystemTask* systemTask = nullptr;
+      Utility::DataChangeNotifier changeNotifier {Utility::DataSource::Battery};
     };
   }
 }
@@ -12,6 +12,7 @@ namespace Pinetime {
 
   namespace Controllers {
     class Battery;
+    class NotificationScheduler;
 
     class BatteryInformationService {
     public:
@@ -19,7 +20,7 @@ namespace Pinetime {
       void Init();
 
       int OnBatteryServiceRequested(uint16_t attributeHandle, ble_gatt_access_ctxt* context);
-      void NotifyBatteryLevel(uint16_t connectionHandle, uint8_t level);
+      void NotifyBatteryLevel(NotificationScheduler& scheduler, uint8_t level);
 
     private:
       Controllers::Battery& batteryController;
@@ -8,10 +8,12 @@ bool Ble::IsConnected() const {
 
 void Ble::Connect() {
   isConnected = true;
+  changeNotifier.Notify();
 }
 
 void Ble::Disconnect() {
   isConnected = false;
+  changeNotifier.Notify();
 }
 
 bool Ble::IsRadioEnabled() const {
@@ -20,10 +22,12 @@ bool Ble::IsRadioEnabled() const {
 
 void Ble::EnableRadio() {
   isRadioEnabled = true;
+  changeNotifier.Notify();
 }
 
 void Ble::DisableRadio() {
   isRadioEnabled = false;
+  changeNotifier.Notify();
 }
 
 void Ble::StartFirmwareUpdate() {
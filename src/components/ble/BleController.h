@@ -2,6 +2,7 @@
 
 #include <array>
 #include <cstdint>
+#include "utility/DataChangeNotifier.h"
 
 namespace Pinetime {
   namespace Controllers {
@@ -65,6 +66,10 @@ namespace Pinetime {
         return pairingKey;
       }
 
+      void Subscribe(Utility::DataChangeListener* listener) {
+        changeNotifier.Subscribe(listener);
+      }
+
     private:
       bool isConnected = false;
       bool isRadioEnabled = true;
@@ -75,6 +80,7 @@ namespace Pinetime {
       BleAddress address;
       AddressTypes addressType;
       uint32_t pairingKey = 0;
+      Utility::DataChangeNotifier changeNotifier {Utility::DataSource::Ble};
     };
   }
 }
@@ -0,0 +1,150 @@
+#include "components/ble/ConnectionParametersManager.h"
+#define min // workaround: nimble's min/max macros conflict with libstdc++
+#define max
+#include <host/ble_gap.h>
+#undef max
+#undef min
+#include <libraries/log/nrf_log.h>
+
+using namespace Pinetime::Controllers;
+
+constexpr std::array<ConnectionParametersManager::Parameters, ConnectionParametersManager::NbModes> ConnectionParametersManager::parameters;
+
+namespace {
+  void TimerCallback(TimerHandle_t xTimer) {
+    auto* manager = static_cast<ConnectionParametersManager*>(pvTimerGetTimerID(xTimer));
+    manager->OnTimer();
+  }
+}
+
+ConnectionParametersManager::ConnectionParametersManager() : connectionHandle {BLE_HS_CONN_HANDLE_NONE} {
+  timer = xTimerCreate("connParams", idleDelay, pdFALSE, this, TimerCallback);
+}
+
+void ConnectionParametersManager::Acquire(Workloads workload) {
+  workloads[static_cast<uint8_t>(workload)]++;
+  Schedule(1);
+}
+
+void ConnectionParametersManager::Release(Workloads workload) {
+  auto& count = workloads[static_cast<uint8_t>(workload)];
+  if (count > 0) {
+    count--;
+  }
+  lastRelease = xTaskGetTickCount();
+  Schedule(idleDelay);
+}
+
+void ConnectionParametersManager::OnConnect(uint16_t handle) {
+  connectionHandle = handle;
+  lastRelease = xTaskGetTickCount();
+  Schedule((WantedMode() == Modes::Idle) ? idleDelay : 1);
+}
+
+void ConnectionParametersManager::OnDisconnect() {
+  connectionHandle = BLE_HS_CONN_HANDLE_NONE;
+  interval = 0;
+  latency = 0;
+  Schedule(1);
+}
+
+void ConnectionParametersManager::OnConnectionUpdated(uint16_t handle, int status) {
+  if (status != 0) {
+    nbRejected++;
+  }
+  ble_gap_conn_desc desc;
+  if (ble_gap_conn_find(handle, &desc) == 0) {
+    interval = desc.conn_itvl;
+    latency = desc.conn_latency;
+  }
+}
+
+ConnectionParametersManager::Modes ConnectionParametersManager::WantedMode() const {
+  if (workloads[static_cast<uint8_t>(Workloads::FirmwareUpdate)] > 0 || workloads[static_cast<uint8_t>(Workloads::FileTransfer)] > 0) {
+    return Modes::Transfer;
+  }
+  if (workloads[static_cast<uint8_t>(Workloads::MotionStreaming)] > 0) {
+    return Modes::Streaming;
+  }
+  return Modes::Idle;
+}
+
+void ConnectionParametersManager::Schedule(TickType_t delay) {
+  // A pending request for faster parameters must not be delayed by a release
+  if (xTimerIsTimerActive(timer) == pdTRUE && delay > 1 && WantedMode() != Modes::Idle) {
+    return;
+  }
+  xTimerChangePeriod(timer, delay, 0);
+}
+
+void ConnectionParametersManager::Account(TickType_t now) {
+  if (connected) {
+    timeInMode[static_cast<uint8_t>(mode)] += now - modeSince;
+  }
+  modeSince = now;
+}
+
+void ConnectionParametersManager::OnTimer() {
+  TickType_t now = xTaskGetTickCount();
+  uint16_t handle = connectionHandle;
+  if (handle == BLE_HS_CONN_HANDLE_NONE) {
+    Account(now);
+    connected = false;
+    parametersRequested = false;
+    mode = Modes::Idle;
+    return;
+  }
+
+  if (!connected) {
+    connected = true;
+    modeSince = now;
+    // Data length extension is negotiated by the controller itself, only the PHY has to be requested
+    ble_gap_set_prefered_le_phy(handle, BLE_GAP_LE_PHY_2M_MASK, BLE_GAP_LE_PHY_2M_MASK, 0);
+  }
+
+  Modes wanted = WantedMode();
+  if (parametersRequested && wanted == mode) {
+    return;
+  }
+  if (wanted < mode || (!parametersRequested && wanted == Modes::Idle)) {
+    TickType_t idleFor = now - lastRelease;
+    if (idleFor < idleDelay) {
+      Schedule(idleDelay - idleFor);
+      return;
+    }
+  }
+
+  const Parameters& p = parameters[static_cast<uint8_t>(wanted)];
+  ble_gap_upd_params params {};
+  params.itvl_min = p.minInterval;
+  params.itvl_max = p.maxInterval;
+  params.latency = p.latency;
+  params.supervision_timeout = p.supervisionTimeout;
+  int res = ble_gap_update_params(handle, &params);
+  nbRequests++;
+  if (res != 0) {
+    // Most likely another update is still in progress
+    NRF_LOG_INFO("[ConnParams] update to mode %d failed : %d", wanted, res);
+    Schedule(retryDelay);
+    return;
+  }
+
+  NRF_LOG_INFO("[ConnParams] mode %d -> %d", mode, wanted);
+  Account(now);
+  mode = wanted;
+  parametersRequested = true;
+}
+
+ConnectionParametersManager::Stats ConnectionParametersManager::GetStats() const {
+  Stats stats;
+  stats.timeInMode = timeInMode;
+  stats.mode = mode;
+  if (connected) {
+    stats.timeInMode[static_cast<uint8_t>(mode)] += xTaskGetTickCount() - modeSince;
+  }
+  stats.interval = interval;
+  stats.latency = latency;
+  stats.nbRequests = nbRequests;
+  stats.nbRejected = nbRejected;
+  return stats;
+}
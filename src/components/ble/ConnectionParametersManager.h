@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <FreeRTOS.h>
+#include <timers.h>
+
+namespace Pinetime {
+  namespace Controllers {
+    /** Chooses the connection parameters requested to the central according to what the BLE link is used for:
+     * a short interval while a firmware update or a file transfer is running, a medium one while motion values are
+     * streamed, and a long interval with slave latency the rest of the time to save power.
+     *
+     * Workloads are reference counted with Acquire()/Release(). Faster parameters are requested right away, slower
+     * ones only after the link has been idle for a while, so that back to back commands do not renegotiate the
+     * connection every time. All requests are sent from a timer callback. */
+    class ConnectionParametersManager {
+    public:
+      enum class Workloads : uint8_t { FirmwareUpdate, FileTransfer, MotionStreaming };
+      enum class Modes : uint8_t { Idle, Streaming, Transfer };
+      static constexpr uint8_t NbModes = 3;
+
+      struct Stats {
+        // Time spent connected in each mode, in ticks
+        std::array<TickType_t, NbModes> timeInMode;
+        Modes mode;
+        // Current connection interval, in 1.25 ms units (0 when disconnected)
+        uint16_t interval;
+        uint16_t latency;
+        uint32_t nbRequests;
+        uint32_t nbRejected;
+      };
+
+      ConnectionParametersManager();
+
+      void Acquire(Workloads workload);
+      void Release(Workloads workload);
+
+      void OnConnect(uint16_t connectionHandle);
+      void OnDisconnect();
+      void OnConnectionUpdated(uint16_t connectionHandle, int status);
+
+      Stats GetStats() const;
+
+      void OnTimer();
+
+    private:
+      struct Parameters {
+        uint16_t minInterval;        // 1.25 ms units
+        uint16_t maxInterval;        // 1.25 ms units
+        uint16_t latency;            // connection events
+        uint16_t supervisionTimeout; // 10 ms units
+      };
+
+      // Indexed by Modes. They follow the Apple accessory guidelines: maxInterval >= minInterval + 15 ms,
+      // maxInterval * (latency + 1) <= 2 s and supervisionTimeout > 3 * maxInterval * (latency + 1)
+      static constexpr std::array<Parameters, NbModes> parameters {{
+        {144, 192, 4, 600}, // 180-240 ms, 4 events of latency, 6 s timeout
+        {24, 48, 0, 400},   // 30-60 ms
+        {12, 24, 0, 400},   // 15-30 ms
+      }};
+
+      // How long the link must have been without workload before slower parameters are requested.
+      // Also used after the connection is established, to let the central discover the services first.
+      static constexpr TickType_t idleDelay = pdMS_TO_TICKS(10000);
+      static constexpr TickType_t retryDelay = pdMS_TO_TICKS(1000);
+
+      Modes WantedMode() const;
+      void Schedule(TickType_t delay);
+      void Account(TickType_t now);
+
+      TimerHandle_t timer;
+      std::array<std::atomic<uint8_t>, 3> workloads {};
+      std::atomic<uint16_t> connectionHandle;
+      std::atomic<TickType_t> lastRelease {0};
+
+      // Only written in OnTimer()
+      bool connected = false;
+      bool parametersRequested = false;
+      Modes mode = Modes::Idle;
+      TickType_t modeSince = 0;
+      std::array<TickType_t, NbModes> timeInMode {};
+      uint32_t nbRequests = 0;
+
+      // Only written in OnConnectionUpdated()
+      uint16_t interval = 0;
+      uint16_t latency = 0;
+      uint32_t nbRejected = 0;
+    };
+  }
+}
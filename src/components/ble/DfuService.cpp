@@ -1,4 +1,5 @@
 #include "components/ble/DfuService.h"
+#include <algorithm>
 #include <cstring>
 #include "components/ble/BleController.h"
 #include "components/ble/NotificationManager.h"
@@ -9,6 +10,23 @@
 
 using namespace Pinetime::Controllers;
 
+namespace {
+  // CRC-16/CCITT (polynomial 0x1021, MSB first), one entry for each value of the byte entering the CRC
+  constexpr std::array<uint16_t, 256> GenerateCrcTable() {
+    std::array<uint16_t, 256> table {};
+    for (uint16_t i = 0; i < 256; i++) {
+      uint16_t crc = i << 8;
+      for (uint8_t bit = 0; bit < 8; bit++) {
+        crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+      }
+      table[i] = crc;
+    }
+    return table;
+  }
+
+  constexpr std::array<uint16_t, 256> crcTable = GenerateCrcTable();
+}
+
 constexpr ble_uuid128_t DfuService::serviceUuid;
 constexpr ble_uuid128_t DfuService::controlPointCharacteristicUuid;
 constexpr ble_uuid128_t DfuService::revisionCharacteristicUuid;
@@ -145,8 +163,6 @@ int DfuService::WritePacketHandler(uint16_t connectionHandle, os_mbuf* om) {
         vTaskDelay(pdMS_TO_TICKS(5));
       }
 
-      dfuImage.Erase();
-
       uint8_t data[] {16, 1, 1};
       notificationManager.Send(connectionHandle, controlPointCharacteristicHandle, data, 3);
       state = States::Init;
@@ -177,8 +193,11 @@ int DfuService::WritePacketHandler(uint16_t connectionHandle, os_mbuf* om) {
 
     case States::Data: {
       nbPacketReceived++;
-      dfuImage.Append(om->om_data, om->om_len);
-      bytesReceived += om->om_len;
+      // Large packets can be split over several chained buffers
+      for (os_mbuf* buffer = om; buffer != nullptr; buffer = SLIST_NEXT(buffer, om_next)) {
+        dfuImage.Append(buffer->om_data, buffer->om_len);
+      }
+      bytesReceived += OS_MBUF_PKTLEN(om);
       bleController.FirmwareUpdateCurrentBytes(bytesReceived);
 
       if ((nbPacketReceived % nbPacketsToNotify) == 0 && bytesReceived != applicationSize) {
@@ -195,6 +214,15 @@ int DfuService::WritePacketHandler(uint16_t connectionHandle, os_mbuf* om) {
                          static_cast<uint8_t>(Opcodes::ReceiveFirmwareImage),
                          static_cast<uint8_t>(ErrorCodes::NoError)};
         NRF_LOG_INFO("[DFU] -> Send packet notification : all bytes received!");
+        uint32_t elapsedMs = (xTaskGetTickCount() - dataStartTicks) * 1000 / configTICK_RATE_HZ;
+        uint32_t bytesPerSecond = (elapsedMs > 0) ? (uint64_t) bytesReceived * 1000 / elapsedMs : 0;
+        auto programStats = dfuImage.GetProgramStats();
+        NRF_LOG_INFO("[DFU] %d bytes in %d ms (%d B/s), flash : %d pages programmed, %d yields",
+                     bytesReceived,
+                     elapsedMs,
+                     bytesPerSecond,
+                     programStats.nbPages,
+                     programStats.nbYields);
         notificationManager.Send(connectionHandle, controlPointCharacteristicHandle, data, 3);
         state = States::Validate;
       }
@@ -262,9 +290,16 @@ int DfuService::ControlPointHandler(uint16_t connectionHandle, os_mbuf* om) {
         NRF_LOG_INFO("[DFU] -> Receive firmware image requested, but we are not in Start Init");
         return 0;
       }
-      // TODO the chunk size is dependent of the implementation of the host application...
-      dfuImage.Init(20, applicationSize, expectedCrc);
+      if (!dfuImage.Init(applicationSize, expectedCrc)) {
+        NRF_LOG_INFO("[DFU] -> Receive firmware image requested, but the image is too large (%d bytes)", applicationSize);
+        uint8_t data[3] {static_cast<uint8_t>(Opcodes::Response),
+                         static_cast<uint8_t>(Opcodes::ReceiveFirmwareImage),
+                         static_cast<uint8_t>(ErrorCodes::DataSizeExceedsLimits)};
+        notificationManager.Send(connectionHandle, controlPointCharacteristicHandle, data, 3);
+        return 0;
+      }
       NRF_LOG_INFO("[DFU] -> Starting receive firmware");
+      dataStartTicks = xTaskGetTickCount();
       state = States::Data;
       return 0;
     case Opcodes::ValidateFirmware: {
@@ -366,36 +401,42 @@ void DfuService::NotificationManager::Reset() {
   xTimerStop(timer, 0);
 }
 
-void DfuService::DfuImage::Init(size_t chunkSize, size_t totalSize, uint16_t expectedCrc) {
-  if (chunkSize != 20)
-    return;
-  this->chunkSize = chunkSize;
+bool DfuService::DfuImage::Init(size_t totalSize, uint16_t expectedCrc) {
+  if (totalSize > maxSize)
+    return false;
   this->totalSize = totalSize;
   this->expectedCrc = expectedCrc;
   this->ready = true;
   totalWriteIndex = 0;
   bufferWriteIndex = 0;
+  erasedSize = 0;
+  receivedCrc = crcInit;
+  return true;
 }
 
-void DfuService::DfuImage::Append(uint8_t* data, size_t size) {
+void DfuService::DfuImage::Append(const uint8_t* data, size_t size) {
   if (!ready)
     return;
-  ASSERT(size <= 20);
-
-  std::memcpy(tempBuffer + bufferWriteIndex, data, size);
-  bufferWriteIndex += size;
-
-  if (bufferWriteIndex == bufferSize) {
-    spiNorFlash.Write(writeOffset + totalWriteIndex, tempBuffer, bufferWriteIndex);
-    totalWriteIndex += bufferWriteIndex;
-    bufferWriteIndex = 0;
-  }
 
-  if (bufferWriteIndex > 0 && totalWriteIndex + bufferWriteIndex == totalSize) {
-    spiNorFlash.Write(writeOffset + totalWriteIndex, tempBuffer, bufferWriteIndex);
-    totalWriteIndex += bufferWriteIndex;
-    if (totalSize < maxSize)
-      WriteMagicNumber();
+  // writeOffset is page aligned, so a full buffer is always exactly one page of the flash
+  while (size > 0 && totalWriteIndex + bufferWriteIndex < totalSize) {
+    size_t count = std::min(size, bufferSize - bufferWriteIndex);
+    std::memcpy(tempBuffer + bufferWriteIndex, data, count);
+    receivedCrc = ComputeCrc(data, count, receivedCrc);
+    bufferWriteIndex += count;
+    data += count;
+    size -= count;
+
+    if (bufferWriteIndex == bufferSize || totalWriteIndex + bufferWriteIndex == totalSize) {
+      EraseAhead(std::min(totalWriteIndex + bufferSize + eraseAhead, maxSize));
+      spiNorFlash.Write(writeOffset + totalWriteIndex, tempBuffer, bufferWriteIndex);
+      totalWriteIndex += bufferWriteIndex;
+      bufferWriteIndex = 0;
+      if (totalWriteIndex == totalSize && totalSize < maxSize) {
+        EraseTrailer();
+        WriteMagicNumber();
+      }
+    }
   }
 }
 
@@ -412,44 +453,44 @@ void DfuService::DfuImage::WriteMagicNumber() {
   spiNorFlash.Write(offset, reinterpret_cast<const uint8_t*>(magic), 4 * sizeof(uint32_t));
 }
 
-void DfuService::DfuImage::Erase() {
-  for (size_t erased = 0; erased < maxSize; erased += 0x1000) {
-    spiNorFlash.SectorErase(writeOffset + erased);
+void DfuService::DfuImage::EraseAhead(size_t size) {
+  while (erasedSize < size) {
+    spiNorFlash.SectorErase(writeOffset + erasedSize);
+    erasedSize += Pinetime::Drivers::SpiNorFlash::sectorSize;
+  }
+}
+
+// The magic number is written in the last sector of the region, the sectors between the image and this one are not used
+void DfuService::DfuImage::EraseTrailer() {
+  static constexpr size_t sectorSize = Pinetime::Drivers::SpiNorFlash::sectorSize;
+  const size_t trailerSector = (maxSize - 4 * sizeof(uint32_t)) / sectorSize * sectorSize;
+  if (erasedSize <= trailerSector) {
+    spiNorFlash.SectorErase(writeOffset + trailerSector);
   }
 }
 
 bool DfuService::DfuImage::Validate() {
-  uint32_t chunkSize = 200;
-  size_t currentOffset = 0;
-  uint16_t crc = 0;
+  if (receivedCrc != expectedCrc)
+    return false;
+  if (!readBackVerify)
+    return true;
 
-  bool first = true;
+  size_t currentOffset = 0;
+  uint16_t crc = crcInit;
   while (currentOffset < totalSize) {
-    uint32_t readSize = (totalSize - currentOffset) > chunkSize ? chunkSize : (totalSize - currentOffset);
-
+    size_t readSize = std::min(totalSize - currentOffset, bufferSize);
     spiNorFlash.Read(writeOffset + currentOffset, tempBuffer, readSize);
-    if (first) {
-      crc = ComputeCrc(tempBuffer, readSize, NULL);
-      first = false;
-    } else
-      crc = ComputeCrc(tempBuffer, readSize, &crc);
+    crc = ComputeCrc(tempBuffer, readSize, crc);
     currentOffset += readSize;
   }
 
   return (crc == expectedCrc);
 }
 
-uint16_t DfuService::DfuImage::ComputeCrc(uint8_t const* p_data, uint32_t size, uint16_t const* p_crc) {
-  uint16_t crc = (p_crc == NULL) ? 0xFFFF : *p_crc;
-
-  for (uint32_t i = 0; i < size; i++) {
-    crc = static_cast<uint8_t>(crc >> 8) | (crc << 8);
-    crc ^= p_data[i];
-    crc ^= static_cast<uint8_t>(crc & 0xFF) >> 4;
-    crc ^= (crc << 8) << 4;
-    crc ^= ((crc & 0xFF) << 4) << 1;
+uint16_t DfuService::DfuImage::ComputeCrc(const uint8_t* data, size_t size, uint16_t crc) {
+  for (size_t i = 0; i < size; i++) {
+    crc = (crc << 8) ^ crcTable[(crc >> 8) ^ data[i]];
   }
-
   return crc;
 }
 
@@ -8,16 +8,13 @@
 #include <host/ble_gap.h>
 #undef max
 #undef min
+#include "drivers/SpiNorFlash.h"
 
 namespace Pinetime {
   namespace System {
     class SystemTask;
   }
 
-  namespace Drivers {
-    class SpiNorFlash;
-  }
-
   namespace Controllers {
     class Ble;
     class Settings;
@@ -56,27 +53,42 @@ namespace Pinetime {
         DfuImage(Pinetime::Drivers::SpiNorFlash& spiNorFlash) : spiNorFlash {spiNorFlash} {
         }
 
-        void Init(size_t chunkSize, size_t totalSize, uint16_t expectedCrc);
-        void Erase();
-        void Append(uint8_t* data, size_t size);
+        bool Init(size_t totalSize, uint16_t expectedCrc);
+        void Append(const uint8_t* data, size_t size);
         bool Validate();
         bool IsComplete();
 
+        Pinetime::Drivers::SpiNorFlash::ProgramStats GetProgramStats() const {
+          return spiNorFlash.GetProgramStats();
+        }
+
       private:
         Pinetime::Drivers::SpiNorFlash& spiNorFlash;
-        static constexpr size_t bufferSize = 200;
+        // Packets can have any size up to the ATT MTU: they are staged until a whole flash page is available,
+        // so that each write to the flash is a single page program
+        static constexpr size_t bufferSize = Pinetime::Drivers::SpiNorFlash::pageSize;
         bool ready = false;
-        size_t chunkSize = 0;
         size_t totalSize = 0;
         size_t maxSize = 475136;
         size_t bufferWriteIndex = 0;
         size_t totalWriteIndex = 0;
+        // The OTA region is erased on demand, sector by sector a few sectors ahead of the data, so that the host task
+        // is never blocked by more than a sector erase while packets are received
+        size_t erasedSize = 0;
+        static constexpr size_t eraseAhead = 2 * Pinetime::Drivers::SpiNorFlash::sectorSize;
         static constexpr size_t writeOffset = 0x40000;
         uint8_t tempBuffer[bufferSize];
         uint16_t expectedCrc = 0;
-
+        static constexpr uint16_t crcInit = 0xFFFF;
+        // CRC of the data received so far, updated in Append()
+        uint16_t receivedCrc = crcInit;
+        // Also read the image back from the flash and check its CRC in Validate(), to detect program failures
+        static constexpr bool readBackVerify = false;
+
+        void EraseAhead(size_t size);
+        void EraseTrailer();
         void WriteMagicNumber();
-        uint16_t ComputeCrc(uint8_t const* p_data, uint32_t size, uint16_t const* p_crc);
+        static uint16_t ComputeCrc(const uint8_t* data, size_t size, uint16_t crc);
       };
 
       static constexpr ble_uuid128_t serviceUuid {
@@ -151,6 +163,7 @@ namespace Pinetime {
       uint8_t nbPacketsToNotify = 0;
       uint32_t nbPacketReceived = 0;
       uint32_t bytesReceived = 0;
+      TickType_t dataStartTicks = 0;
 
       uint32_t softdeviceSize = 0;
       uint32_t bootloaderSize = 0;
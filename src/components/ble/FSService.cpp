@@ -10,6 +10,7 @@ using namespace Pinetime::Controllers;
 constexpr ble_uuid16_t FSService::fsServiceUuid;
 constexpr ble_uuid128_t FSService::fsVersionUuid;
 constexpr ble_uuid128_t FSService::fsTransferUuid;
+constexpr ble_uuid128_t FSService::fsStatsUuid;
 
 int FSServiceCallback(uint16_t conn_handle, uint16_t attr_handle, struct ble_gatt_access_ctxt* ctxt, void* arg) {
   auto* fsService = static_cast<FSService*>(arg);
@@ -28,9 +29,14 @@ FSService::FSService(Pinetime::System::SystemTask& systemTask, Pinetime::Control
                                 .uuid = &fsTransferUuid.u,
                                 .access_cb = FSServiceCallback,
                                 .arg = this,
-                                .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_NOTIFY,
+                                .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_WRITE_NO_RSP | BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_NOTIFY,
                                 .val_handle = &transferCharacteristicHandle,
                               },
+                              {.uuid = &fsStatsUuid.u,
+                               .access_cb = FSServiceCallback,
+                               .arg = this,
+                               .flags = BLE_GATT_CHR_F_READ,
+                               .val_handle = &statsCharacteristicHandle},
                               {0}},
     serviceDefinition {
       {/* Device Information Service */
@@ -48,6 +54,8 @@ void FSService::Init() {
 
   res = ble_gatts_add_svcs(serviceDefinition);
   ASSERT(res == 0);
+
+  ble_npl_callout_init(&readStreamRetry, nimble_port_get_dflt_eventq(), OnReadStreamRetry, this);
 }
 
 int FSService::OnFSServiceRequested(uint16_t connectionHandle, uint16_t attributeHandle, ble_gatt_access_ctxt* context) {
@@ -71,11 +79,36 @@ int FSService::OnFSServiceRequested(uint16_t connectionHandle, uint16_t attribut
   if (attributeHandle == transferCharacteristicHandle) {
     return FSCommandHandler(connectionHandle, context->om);
   }
+  if (attributeHandle == statsCharacteristicHandle) {
+    const auto& stats = fs.GetUsageStats();
+    StatsResponse resp;
+    resp.blockSize = fs.getBlockSize();
+    resp.blockCount = fs.getSize() / fs.getBlockSize();
+    resp.blocksUsed = stats.blocksUsed;
+    resp.freeExtents = stats.freeExtents;
+    resp.largestFreeExtent = stats.largestFreeExtent;
+    resp.erases = stats.erases;
+    resp.programs = stats.programs;
+    resp.maxLockTime = stats.maxLockTime;
+    resp.maintenanceRuns = stats.maintenanceRuns;
+    resp.maintenanceTime = stats.maintenanceTime;
+    int res = os_mbuf_append(context->om, &resp, sizeof(resp));
+    return (res == 0) ? 0 : BLE_ATT_ERR_INSUFFICIENT_RES;
+  }
   return 0;
 }
 
 int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
   auto command = static_cast<commands>(om->om_data[0]);
+  // Sent many times during a streaming session, which keeps the watch awake: skip the wake up below
+  if (command == commands::READ_CREDIT) {
+    OnReadCredit(connectionHandle, om);
+    return 0;
+  }
+  if (command == commands::WRITE_STREAM_DATA) {
+    OnWriteStreamData(connectionHandle, om);
+    return 0;
+  }
   NRF_LOG_INFO("[FS_S] -> FSCommandHandler Command %d", command);
   // Just always make sure we are awake...
   systemTask.PushMessage(Pinetime::System::Messages::StartFileTransfer);
@@ -108,7 +141,7 @@ int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
         resp.totallen = 0;
         om = ble_hs_mbuf_from_flat(&resp, sizeof(ReadResponse));
       } else {
-        resp.chunklen = std::min(header->chunksize, info.size); // TODO add mtu somehow
+        resp.chunklen = std::min<uint32_t>(std::min(header->chunksize, info.size), ChunkSize(connectionHandle));
         resp.totallen = info.size;
         fs.FileOpen(&f, filepath, LFS_O_RDONLY);
         fs.FileSeek(&f, header->chunkoff);
@@ -135,7 +168,7 @@ int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
         resp.chunklen = 0;
         resp.totallen = 0;
       } else {
-        resp.chunklen = std::min(header->chunksize, info.size); // TODO add mtu somehow
+        resp.chunklen = std::min<uint32_t>(std::min(header->chunksize, info.size), ChunkSize(connectionHandle));
         resp.totallen = info.size;
         fs.FileOpen(&f, filepath, LFS_O_RDONLY);
         fs.FileSeek(&f, header->chunkoff);
@@ -154,6 +187,18 @@ int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
       ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om);
       break;
     }
+    case commands::READ_STREAM: {
+      NRF_LOG_INFO("[FS_S] -> ReadStream");
+      // The request may be split over several mbufs when the MTU is large
+      ReadStreamHeader header;
+      if (os_mbuf_copydata(om, 0, sizeof(ReadStreamHeader), &header) != 0 || header.pathlen >= maxpathlen ||
+          os_mbuf_copydata(om, sizeof(ReadStreamHeader), header.pathlen, filepath) != 0) {
+        return -1;
+      }
+      filepath[header.pathlen] = 0;
+      StartReadStream(connectionHandle, header);
+      break;
+    }
     case commands::WRITE: {
       NRF_LOG_INFO("[FS_S] -> Write");
       auto* header = (WriteHeader*) om->om_data;
@@ -195,12 +240,26 @@ int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
       }
       if (res < 0) {
         resp.status = (int8_t) res;
+      } else if (header->offset + header->dataSize == fileSize) {
+        OnFileChanged(filepath);
       }
       resp.freespace = std::min(fs.getSize() - (fs.GetFSSize() * fs.getBlockSize()), fileSize - header->offset);
       auto* om = ble_hs_mbuf_from_flat(&resp, sizeof(WriteResponse));
       ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om);
       break;
     }
+    case commands::WRITE_STREAM: {
+      NRF_LOG_INFO("[FS_S] -> WriteStream");
+      // The request may be split over several mbufs when the MTU is large
+      WriteHeader header;
+      if (os_mbuf_copydata(om, 0, sizeof(WriteHeader), &header) != 0 || header.pathlen >= maxpathlen ||
+          os_mbuf_copydata(om, sizeof(WriteHeader), header.pathlen, filepath) != 0) {
+        return -1;
+      }
+      filepath[header.pathlen] = 0;
+      StartWriteStream(connectionHandle, header);
+      break;
+    }
     case commands::DELETE: {
       NRF_LOG_INFO("[FS_S] -> Delete");
       auto* header = (DelHeader*) om->om_data;
@@ -212,6 +271,9 @@ int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
       resp.command = commands::DELETE_STATUS;
       int res = fs.FileDelete(path);
       resp.status = (res == 0) ? 0x01 : (int8_t) res;
+      if (res == 0) {
+        OnFileChanged(path);
+      }
       auto* om = ble_hs_mbuf_from_flat(&resp, sizeof(DelResponse));
       ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om);
       break;
@@ -309,6 +371,9 @@ int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
       resp.command = commands::MOVE_STATUS;
       int8_t res = (int8_t) fs.Rename(header->pathstr, path);
       resp.status = (res == 0) ? 1 : res;
+      if (res == 0) {
+        OnFileChanged(path);
+      }
       auto* om = ble_hs_mbuf_from_flat(&resp, sizeof(MoveResponse));
       ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om);
     }
@@ -342,3 +407,316 @@ void FSService::prepareReadDataResp(ReadHeader* header, ReadResponse* resp) {
     fs.FileClose(&f);
   }
 }
+
+// Largest chunk that fits in a notification with the MTU negotiated on this connection
+uint16_t FSService::ChunkSize(uint16_t connectionHandle) const {
+  uint16_t mtu = ble_att_mtu(connectionHandle);
+  if (mtu < BLE_ATT_MTU_DFLT) {
+    mtu = BLE_ATT_MTU_DFLT;
+  }
+  return std::min<uint16_t>(mtu - 3 - sizeof(ReadResponse), maxChunkSize);
+}
+
+// filepath holds the path of the file
+void FSService::StartReadStream(uint16_t connectionHandle, const ReadStreamHeader& header) {
+  StopReadStream();
+
+  lfs_info info {};
+  int res = fs.Stat(filepath, &info);
+  if (res == 0 && info.type == LFS_TYPE_DIR) {
+    res = LFS_ERR_ISDIR;
+  }
+  if (res == 0) {
+    res = fs.FileOpen(&readStream.file, filepath, LFS_O_RDONLY);
+  }
+  if (res == 0 && header.chunkoff > 0) {
+    res = fs.FileSeek(&readStream.file, std::min(header.chunkoff, info.size));
+    if (res < 0) {
+      fs.FileClose(&readStream.file);
+    }
+  }
+  if (res < 0) {
+    ReadResponse resp {};
+    resp.command = commands::READ_DATA;
+    resp.status = (int8_t) res;
+    resp.chunkoff = header.chunkoff;
+    auto* om = ble_hs_mbuf_from_flat(&resp, sizeof(ReadResponse));
+    ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om);
+    return;
+  }
+
+  readStream.active = true;
+  readStream.connectionHandle = connectionHandle;
+  readStream.offset = std::min(header.chunkoff, info.size);
+  readStream.totalSize = info.size;
+  readStream.credits = header.credits;
+  readStream.chunkSize = ChunkSize(connectionHandle);
+  readStream.nbChunks = 0;
+  readStream.startTicks = xTaskGetTickCount();
+  // The session holds its own wake lock until the last chunk is sent
+  systemTask.PushMessage(Pinetime::System::Messages::StartFileTransfer);
+  NRF_LOG_INFO("[FS_S] Read stream : %d bytes, %d bytes per chunk", readStream.totalSize, readStream.chunkSize);
+
+  SendReadStreamChunks();
+}
+
+// Sends at most maxChunksPerPass chunks, the next ones are sent by the retry callout so that the other events of the
+// host are handled in between. NimBLE doesn't report when the buffer of a notification is freed, the stream
+// waits for free mbufs instead.
+void FSService::SendReadStreamChunks() {
+  for (uint8_t sent = 0; readStream.active && readStream.credits > 0; sent++) {
+    if (sent == maxChunksPerPass) {
+      ble_npl_callout_reset(&readStreamRetry, 0);
+      return;
+    }
+    if (os_msys_num_free() < minFreeMbufs) {
+      ble_npl_callout_reset(&readStreamRetry, ble_npl_time_ms_to_ticks32(readStreamRetryDelayMs));
+      return;
+    }
+
+    ReadResponse resp {};
+    resp.command = commands::READ_DATA;
+    resp.status = 0x01;
+    resp.chunkoff = readStream.offset;
+    resp.totallen = readStream.totalSize;
+    int res = fs.FileRead(&readStream.file, readStreamBuffer, std::min<uint32_t>(readStream.chunkSize, readStream.totalSize - readStream.offset));
+    if (res < 0) {
+      resp.status = (int8_t) res;
+      res = 0;
+    }
+    resp.chunklen = res;
+
+    auto* om = ble_hs_mbuf_from_flat(&resp, sizeof(ReadResponse));
+    if (om != nullptr && os_mbuf_append(om, readStreamBuffer, resp.chunklen) != 0) {
+      os_mbuf_free_chain(om);
+      om = nullptr;
+    }
+
+    // The stream is updated before the notification is sent, and restored if it can't be sent
+    readStream.offset += resp.chunklen;
+    readStream.credits--;
+    readStream.nbChunks++;
+    if (om == nullptr || ble_gattc_notify_custom(readStream.connectionHandle, transferCharacteristicHandle, om) != 0) {
+      // Out of buffers: send this chunk again after a while
+      readStream.offset = resp.chunkoff;
+      readStream.credits++;
+      readStream.nbChunks--;
+      fs.FileSeek(&readStream.file, readStream.offset);
+      ble_npl_callout_reset(&readStreamRetry, ble_npl_time_ms_to_ticks32(readStreamRetryDelayMs));
+      return;
+    }
+
+    if (resp.status != 0x01 || readStream.offset >= readStream.totalSize) {
+      StopReadStream();
+    }
+  }
+}
+
+void FSService::OnReadStreamRetry(ble_npl_event* event) {
+  auto* fsService = static_cast<FSService*>(ble_npl_event_get_arg(event));
+  fsService->SendReadStreamChunks();
+}
+
+void FSService::StopReadStream() {
+  if (!readStream.active) {
+    return;
+  }
+  ble_npl_callout_stop(&readStreamRetry);
+  fs.FileClose(&readStream.file);
+  readStream.active = false;
+  systemTask.PushMessage(Pinetime::System::Messages::StopFileTransfer);
+
+  uint32_t elapsedMs = (xTaskGetTickCount() - readStream.startTicks) * 1000 / configTICK_RATE_HZ;
+  uint32_t bytesPerSecond = (elapsedMs > 0) ? (uint64_t) readStream.offset * 1000 / elapsedMs : 0;
+  NRF_LOG_INFO("[FS_S] Read stream done : %d bytes in %d chunks, %d ms (%d B/s)",
+               readStream.offset,
+               readStream.nbChunks,
+               elapsedMs,
+               bytesPerSecond);
+}
+
+void FSService::OnReadCredit(uint16_t connectionHandle, os_mbuf* om) {
+  ReadCredit header;
+  if (!readStream.active || readStream.connectionHandle != connectionHandle ||
+      os_mbuf_copydata(om, 0, sizeof(ReadCredit), &header) != 0) {
+    return;
+  }
+  if (header.credits == 0) {
+    StopReadStream();
+  } else {
+    readStream.credits += header.credits;
+    SendReadStreamChunks();
+  }
+}
+
+// filepath holds the path of the file
+void FSService::StartWriteStream(uint16_t connectionHandle, const WriteHeader& header) {
+  StopWriteStream();
+
+  writeStream.connectionHandle = connectionHandle;
+  writeStream.offset = header.offset;
+  writeStream.totalSize = header.totalSize;
+
+  int res = 0;
+  uint32_t freeSpace = fs.getSize() - (fs.GetFSSize() * fs.getBlockSize());
+  if (header.offset > header.totalSize) {
+    res = LFS_ERR_INVAL;
+  } else if (header.totalSize - header.offset > freeSpace) {
+    res = LFS_ERR_NOSPC;
+  }
+  if (res == 0) {
+    // A new upload replaces the file, a resumed one keeps what was already received
+    res = fs.FileOpen(&writeStream.file, filepath, LFS_O_WRONLY | LFS_O_CREAT | ((header.offset == 0) ? LFS_O_TRUNC : 0));
+  }
+  if (res == 0 && header.offset > 0) {
+    res = fs.FileSeek(&writeStream.file, header.offset);
+    if (res < 0) {
+      fs.FileClose(&writeStream.file);
+    }
+  }
+  if (res < 0) {
+    SendWriteStreamAck((int8_t) res);
+    return;
+  }
+
+  writeStream.active = true;
+  writeStream.bufferOffset = header.offset;
+  writeStream.bufferSize = 0;
+  writeStream.lastCheckpoint = header.offset;
+  writeStream.chunksSinceAck = 0;
+  writeStream.nbChunks = 0;
+  writeStream.startTicks = xTaskGetTickCount();
+  // The session holds its own wake lock until the file is complete
+  systemTask.PushMessage(Pinetime::System::Messages::StartFileTransfer);
+  NRF_LOG_INFO("[FS_S] Write stream : %d bytes from offset %d", writeStream.totalSize, writeStream.offset);
+
+  if (writeStream.offset == writeStream.totalSize) {
+    StopWriteStream();
+    return;
+  }
+  SendWriteStreamAck(0x01);
+}
+
+void FSService::OnWriteStreamData(uint16_t connectionHandle, os_mbuf* om) {
+  if (!writeStream.active || writeStream.connectionHandle != connectionHandle) {
+    return;
+  }
+  // Large chunks are received in chained mbufs, the header and the data are copied out of the chain
+  WritePacing header;
+  if (os_mbuf_copydata(om, 0, sizeof(WritePacing), &header) != 0 || header.dataSize > OS_MBUF_PKTLEN(om) - sizeof(WritePacing) ||
+      header.offset != writeStream.offset || header.dataSize > writeStream.totalSize - writeStream.offset) {
+    // Tell the client where to resume from
+    SendWriteStreamAck(LFS_ERR_INVAL);
+    writeStream.chunksSinceAck = 0;
+    return;
+  }
+
+  // Copy the chunk in the buffer, and write the buffer to the file each time it reaches the end of a flash page
+  uint32_t dataOffset = sizeof(WritePacing);
+  uint32_t size = header.dataSize;
+  int res = 0;
+  while (size > 0 && res >= 0) {
+    uint16_t pageEnd = writeBufferSize - (writeStream.bufferOffset % writeBufferSize);
+    uint16_t count = std::min<uint32_t>(size, pageEnd - writeStream.bufferSize);
+    os_mbuf_copydata(om, dataOffset, count, writeStreamBuffer + writeStream.bufferSize);
+    writeStream.bufferSize += count;
+    dataOffset += count;
+    size -= count;
+    if (writeStream.bufferSize == pageEnd) {
+      res = FlushWriteStream();
+    }
+  }
+  if (res < 0) {
+    SendWriteStreamAck((int8_t) res);
+    StopWriteStream();
+    return;
+  }
+  writeStream.offset += header.dataSize;
+  writeStream.nbChunks++;
+
+  if (writeStream.offset == writeStream.totalSize) {
+    StopWriteStream();
+    return;
+  }
+  if (writeStream.bufferOffset - writeStream.lastCheckpoint >= writeCheckpointSize) {
+    res = fs.FileSync(&writeStream.file);
+    writeStream.lastCheckpoint = writeStream.bufferOffset;
+    if (res < 0) {
+      SendWriteStreamAck((int8_t) res);
+      StopWriteStream();
+      return;
+    }
+  }
+  if (++writeStream.chunksSinceAck >= writeAckInterval) {
+    SendWriteStreamAck(0x01);
+    writeStream.chunksSinceAck = 0;
+  }
+}
+
+int FSService::FlushWriteStream() {
+  if (writeStream.bufferSize == 0) {
+    return 0;
+  }
+  int res = fs.FileWrite(&writeStream.file, writeStreamBuffer, writeStream.bufferSize);
+  writeStream.bufferOffset += writeStream.bufferSize;
+  writeStream.bufferSize = 0;
+  return res;
+}
+
+void FSService::SendWriteStreamAck(int8_t status) {
+  WriteStreamAck ack {};
+  ack.command = commands::WRITE_STREAM_ACK;
+  ack.status = status;
+  ack.window = writeWindow;
+  ack.offset = writeStream.offset;
+  ack.remaining = writeStream.totalSize - writeStream.offset;
+  auto* om = ble_hs_mbuf_from_flat(&ack, sizeof(WriteStreamAck));
+  ble_gattc_notify_custom(writeStream.connectionHandle, transferCharacteristicHandle, om);
+}
+
+// Writes the data still in the buffer and closes the file, which commits its metadata.
+// The client only gets the final acknowledgement when everything is on flash.
+void FSService::StopWriteStream() {
+  if (!writeStream.active) {
+    return;
+  }
+  int res = FlushWriteStream();
+  int closeRes = fs.FileClose(&writeStream.file);
+  if (res >= 0) {
+    res = closeRes;
+  }
+  writeStream.active = false;
+  systemTask.PushMessage(Pinetime::System::Messages::StopFileTransfer);
+
+  if (writeStream.offset == writeStream.totalSize) {
+    SendWriteStreamAck((res < 0) ? (int8_t) res : 0x01);
+    if (res >= 0) {
+      OnFileChanged(filepath);
+    }
+  }
+
+  uint32_t elapsedMs = (xTaskGetTickCount() - writeStream.startTicks) * 1000 / configTICK_RATE_HZ;
+  NRF_LOG_INFO("[FS_S] Write stream done : %d/%d bytes in %d chunks, %d ms",
+               writeStream.offset,
+               writeStream.totalSize,
+               writeStream.nbChunks,
+               elapsedMs);
+}
+
+void FSService::OnDisconnect(uint16_t connectionHandle) {
+  if (readStream.active && readStream.connectionHandle == connectionHandle) {
+    StopReadStream();
+  }
+  if (writeStream.active && writeStream.connectionHandle == connectionHandle) {
+    StopWriteStream();
+  }
+}
+
+void FSService::OnFileChanged(const char* path) {
+  if (strcmp(path, FS::assetImagePath) == 0) {
+    systemTask.PushMessage(Pinetime::System::Messages::AssetImageReceived);
+  } else {
+    // A resource of the package may have been added, replaced or removed
+    systemTask.PushMessage(Pinetime::System::Messages::ResourcesChanged);
+  }
+}
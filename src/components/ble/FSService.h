@@ -2,8 +2,10 @@
 #define min // workaround: nimble's min/max macros conflict with libstdc++
 #define max
 #include <host/ble_gap.h>
+#include <nimble/nimble_port.h>
 #undef max
 #undef min
+#include <FreeRTOS.h>
 
 #include "components/fs/FS.h"
 
@@ -24,6 +26,7 @@ namespace Pinetime {
 
       int OnFSServiceRequested(uint16_t connectionHandle, uint16_t attributeHandle, ble_gatt_access_ctxt* context);
       void NotifyFSRaw(uint16_t connectionHandle);
+      void OnDisconnect(uint16_t connectionHandle);
 
     private:
       Pinetime::System::SystemTask& systemTask;
@@ -35,6 +38,7 @@ namespace Pinetime {
       static constexpr uint16_t FSServiceId {0xFEBB};
       static constexpr uint16_t fsVersionId {0x0100};
       static constexpr uint16_t fsTransferId {0x0200};
+      static constexpr uint16_t fsStatsId {0x0300};
       uint16_t fsVersion = {0x0004};
       static constexpr uint16_t maxpathlen = 256;
       static constexpr ble_uuid16_t fsServiceUuid {
@@ -49,19 +53,29 @@ namespace Pinetime {
         .u {.type = BLE_UUID_TYPE_128},
         .value = {0x72, 0x65, 0x66, 0x73, 0x6e, 0x61, 0x72, 0x54, 0x65, 0x6c, 0x69, 0x46, 0x00, 0x02, 0xAF, 0xAD}};
 
-      struct ble_gatt_chr_def characteristicDefinition[3];
+      static constexpr ble_uuid128_t fsStatsUuid {
+        .u {.type = BLE_UUID_TYPE_128},
+        .value = {0x72, 0x65, 0x66, 0x73, 0x6e, 0x61, 0x72, 0x54, 0x65, 0x6c, 0x69, 0x46, 0x00, 0x03, 0xAF, 0xAD}};
+
+      struct ble_gatt_chr_def characteristicDefinition[4];
       struct ble_gatt_svc_def serviceDefinition[2];
       uint16_t versionCharacteristicHandle;
       uint16_t transferCharacteristicHandle;
+      uint16_t statsCharacteristicHandle;
 
       enum class commands : uint8_t {
         INVALID = 0x00,
         READ = 0x10,
         READ_DATA = 0x11,
         READ_PACING = 0x12,
+        READ_STREAM = 0x13,
+        READ_CREDIT = 0x14,
         WRITE = 0x20,
         WRITE_PACING = 0x21,
         WRITE_DATA = 0x22,
+        WRITE_STREAM = 0x23,
+        WRITE_STREAM_DATA = 0x24,
+        WRITE_STREAM_ACK = 0x25,
         DELETE = 0x30,
         DELETE_STATUS = 0x31,
         MKDIR = 0x40,
@@ -107,6 +121,22 @@ namespace Pinetime {
         uint32_t chunksize;
       };
 
+      using ReadStreamHeader = struct __attribute__((packed)) {
+        commands command;
+        uint8_t padding;
+        uint16_t pathlen;
+        uint32_t chunkoff;
+        uint32_t credits;
+        char pathstr[];
+      };
+
+      using ReadCredit = struct __attribute__((packed)) {
+        commands command;
+        uint8_t padding;
+        uint16_t padding2;
+        uint32_t credits;
+      };
+
       using WriteHeader = struct __attribute__((packed)) {
         commands command;
         uint8_t padding;
@@ -135,6 +165,14 @@ namespace Pinetime {
         uint8_t data[];
       };
 
+      using WriteStreamAck = struct __attribute__((packed)) {
+        commands command;
+        uint8_t status;
+        uint16_t window;
+        uint32_t offset;
+        uint32_t remaining;
+      };
+
       using ListDirHeader = struct __attribute__((packed)) {
         commands command;
         uint8_t padding;
@@ -196,8 +234,83 @@ namespace Pinetime {
         uint8_t status;
       };
 
+      // Value of the stats characteristic, see FS::UsageStats
+      using StatsResponse = struct __attribute__((packed)) {
+        uint32_t blockSize;
+        uint32_t blockCount;
+        uint32_t blocksUsed;
+        uint16_t freeExtents;
+        uint16_t largestFreeExtent;
+        uint32_t erases;
+        uint32_t programs;
+        uint32_t maxLockTime;
+        uint32_t maintenanceRuns;
+        uint32_t maintenanceTime;
+      };
+
+      // Read session started by READ_STREAM: the file stays open and chunks sized from the ATT MTU are notified
+      // back to back, one for each credit granted by the client.
+      struct ReadStream {
+        bool active = false;
+        uint16_t connectionHandle = BLE_HS_CONN_HANDLE_NONE;
+        lfs_file_t file;
+        uint32_t offset;
+        uint32_t totalSize;
+        uint32_t credits;
+        uint16_t chunkSize;
+        uint32_t nbChunks;
+        TickType_t startTicks;
+      };
+
+      // Keep some of the shared mbufs for the other services
+      static constexpr int minFreeMbufs = 4;
+      static constexpr uint8_t maxChunksPerPass = 3;
+      // Delay before a chunk that could not be sent is sent again
+      static constexpr uint32_t readStreamRetryDelayMs = 50;
+      ble_npl_callout readStreamRetry;
+      static constexpr uint16_t maxChunkSize = MYNEWT_VAL(BLE_ATT_PREFERRED_MTU) - 3 - sizeof(ReadResponse);
+      ReadStream readStream;
+      uint8_t readStreamBuffer[maxChunkSize];
+
+      // Write session started by WRITE_STREAM: the file stays open, WRITE_STREAM_DATA chunks are acknowledged
+      // every few chunks and the data is written to littlefs in whole flash pages.
+      struct WriteStream {
+        bool active = false;
+        uint16_t connectionHandle = BLE_HS_CONN_HANDLE_NONE;
+        lfs_file_t file;
+        uint32_t offset;       // all the data before this offset was received
+        uint32_t totalSize;
+        uint32_t bufferOffset; // offset in the file of the first byte of writeStreamBuffer
+        uint16_t bufferSize;
+        uint32_t lastCheckpoint;
+        uint8_t chunksSinceAck;
+        uint32_t nbChunks;
+        TickType_t startTicks;
+      };
+
+      // Number of chunks the client can send before waiting for an acknowledgement
+      static constexpr uint16_t writeWindow = 8;
+      static constexpr uint8_t writeAckInterval = writeWindow / 2;
+      static constexpr uint16_t writeBufferSize = 256; // size of a page of the external flash
+      // File metadata is committed at most this often, and when the file is complete
+      static constexpr uint32_t writeCheckpointSize = 64 * 1024;
+      WriteStream writeStream;
+      uint8_t writeStreamBuffer[writeBufferSize];
+
       int FSCommandHandler(uint16_t connectionHandle, os_mbuf* om);
       void prepareReadDataResp(ReadHeader* header, ReadResponse* resp);
+      uint16_t ChunkSize(uint16_t connectionHandle) const;
+      void StartReadStream(uint16_t connectionHandle, const ReadStreamHeader& header);
+      void SendReadStreamChunks();
+      static void OnReadStreamRetry(ble_npl_event* event);
+      void StopReadStream();
+      void OnReadCredit(uint16_t connectionHandle, os_mbuf* om);
+      void StartWriteStream(uint16_t connectionHandle, const WriteHeader& header);
+      void OnWriteStreamData(uint16_t connectionHandle, os_mbuf* om);
+      int FlushWriteStream();
+      void SendWriteStreamAck(int8_t status);
+      void StopWriteStream();
+      void OnFileChanged(const char* path);
     };
   }
 }
@@ -82,15 +82,7 @@ void MotionService::OnNewStepCountValue(uint32_t stepCount) {
   }
 
   uint32_t buffer = stepCount;
-  auto* om = ble_hs_mbuf_from_flat(&buffer, sizeof(buffer));
-
-  uint16_t connectionHandle = nimble.connHandle();
-
-  if (connectionHandle == 0 || connectionHandle == BLE_HS_CONN_HANDLE_NONE) {
-    return;
-  }
-
-  ble_gattc_notify_custom(connectionHandle, stepCountHandle, om);
+  nimble.notifications().Schedule(stepCountHandle, &buffer, sizeof(buffer));
 }
 
 void MotionService::OnNewMotionValues(int16_t x, int16_t y, int16_t z) {
@@ -99,22 +91,16 @@ void MotionService::OnNewMotionValues(int16_t x, int16_t y, int16_t z) {
   }
 
   int16_t buffer[3] = {x, y, z};
-  auto* om = ble_hs_mbuf_from_flat(buffer, 3 * sizeof(int16_t));
-
-  uint16_t connectionHandle = nimble.connHandle();
-
-  if (connectionHandle == 0 || connectionHandle == BLE_HS_CONN_HANDLE_NONE) {
-    return;
-  }
-
-  ble_gattc_notify_custom(connectionHandle, motionValuesHandle, om);
+  nimble.notifications().Schedule(motionValuesHandle, buffer, sizeof(buffer));
 }
 
 void MotionService::SubscribeNotification(uint16_t attributeHandle) {
   if (attributeHandle == stepCountHandle) {
     stepCountNotificationEnabled = true;
   } else if (attributeHandle == motionValuesHandle) {
-    motionValuesNotificationEnabled = true;
+    if (!motionValuesNotificationEnabled.exchange(true)) {
+      nimble.connectionParameters().Acquire(ConnectionParametersManager::Workloads::MotionStreaming);
+    }
   }
 }
 
@@ -122,6 +108,8 @@ void MotionService::UnsubscribeNotification(uint16_t attributeHandle) {
   if (attributeHandle == stepCountHandle) {
     stepCountNotificationEnabled = false;
   } else if (attributeHandle == motionValuesHandle) {
-    motionValuesNotificationEnabled = false;
+    if (motionValuesNotificationEnabled.exchange(false)) {
+      nimble.connectionParameters().Release(ConnectionParametersManager::Workloads::MotionStreaming);
+    }
   }
 }
@@ -48,7 +48,11 @@ namespace {
   constexpr ble_uuid128_t msRepeatCharUuid {CharUuid(0x0b, 0x00)};
   constexpr ble_uuid128_t msShuffleCharUuid {CharUuid(0x0c, 0x00)};
 
-  constexpr uint8_t MaxStringSize {40};
+  template <size_t N>
+  void SetString(std::array<char, N>& destination, const char* source) {
+    std::strncpy(destination.data(), source, N - 1);
+    destination[N - 1] = '\0';
+  }
 
   int MusicCallback(uint16_t /*conn_handle*/, uint16_t /*attr_handle*/, struct ble_gatt_access_ctxt* ctxt, void* arg) {
     return static_cast<Pinetime::Controllers::MusicService*>(arg)->OnCommand(ctxt);
@@ -113,6 +117,9 @@ Pinetime::Controllers::MusicService::MusicService(Pinetime::Controllers::NimbleC
 
   serviceDefinition[0] = {.type = BLE_GATT_SVC_TYPE_PRIMARY, .uuid = &msUuid.u, .characteristics = characteristicDefinition};
   serviceDefinition[1] = {0};
+
+  mutex = xSemaphoreCreateMutex();
+  ASSERT(mutex != nullptr);
 }
 
 void Pinetime::Controllers::MusicService::Init() {
@@ -144,11 +151,20 @@ int Pinetime::Controllers::MusicService::OnCommand(struct ble_gatt_access_ctxt*
 
     char* s = &data[0];
     if (ble_uuid_cmp(ctxt->chr->uuid, &msArtistCharUuid.u) == 0) {
-      artistName = s;
+      xSemaphoreTake(mutex, portMAX_DELAY);
+      SetString(artistName, s);
+      generation++;
+      xSemaphoreGive(mutex);
     } else if (ble_uuid_cmp(ctxt->chr->uuid, &msTrackCharUuid.u) == 0) {
-      trackName = s;
+      xSemaphoreTake(mutex, portMAX_DELAY);
+      SetString(trackName, s);
+      generation++;
+      xSemaphoreGive(mutex);
     } else if (ble_uuid_cmp(ctxt->chr->uuid, &msAlbumCharUuid.u) == 0) {
-      albumName = s;
+      xSemaphoreTake(mutex, portMAX_DELAY);
+      SetString(albumName, s);
+      generation++;
+      xSemaphoreGive(mutex);
     } else if (ble_uuid_cmp(ctxt->chr->uuid, &msStatusCharUuid.u) == 0) {
       playing = s[0];
       // These variables need to be updated, because the progress may not be updated immediately,
@@ -179,16 +195,18 @@ int Pinetime::Controllers::MusicService::OnCommand(struct ble_gatt_access_ctxt*
   return 0;
 }
 
-std::string Pinetime::Controllers::MusicService::getAlbum() const {
-  return albumName;
-}
-
-std::string Pinetime::Controllers::MusicService::getArtist() const {
-  return artistName;
-}
-
-std::string Pinetime::Controllers::MusicService::getTrack() const {
-  return trackName;
+bool Pinetime::Controllers::MusicService::getTrackInfo(TrackInfo& info) const {
+  // Cheap check first, this is polled by the music app at every refresh
+  if (info.generation == generation) {
+    return false;
+  }
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  info.artist = artistName;
+  info.track = trackName;
+  info.album = albumName;
+  info.generation = generation;
+  xSemaphoreGive(mutex);
+  return true;
 }
 
 bool Pinetime::Controllers::MusicService::isPlaying() const {
@@ -17,8 +17,9 @@
 */
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <cstdint>
-#include <string>
 #define min // workaround: nimble's min/max macros conflict with libstdc++
 #define max
 #include <host/ble_gap.h>
@@ -26,6 +27,7 @@
 #undef max
 #undef min
 #include <FreeRTOS.h>
+#include <semphr.h>
 
 namespace Pinetime {
   namespace Controllers {
@@ -41,11 +43,20 @@ namespace Pinetime {
 
       void event(char event);
 
-      std::string getArtist() const;
+      static constexpr size_t MaxStringSize = 40;
 
-      std::string getTrack() const;
+      struct TrackInfo {
+        std::array<char, MaxStringSize + 1> artist;
+        std::array<char, MaxStringSize + 1> track;
+        std::array<char, MaxStringSize + 1> album;
+        // Generation of the strings above, 0 means they were never copied
+        uint32_t generation = 0;
+      };
 
-      std::string getAlbum() const;
+      /** Copies the artist, track and album into info if they changed since info.generation.
+       * The copy is consistent even if the companion app is writing them at the same time.
+       * @return true if info was updated */
+      bool getTrackInfo(TrackInfo& info) const;
 
       int getProgress() const;
 
@@ -71,9 +82,12 @@ namespace Pinetime {
 
       uint16_t eventHandle {};
 
-      std::string trackName;
-      std::string albumName;
-      std::string artistName {"Not Playing"};
+      std::array<char, MaxStringSize + 1> trackName {};
+      std::array<char, MaxStringSize + 1> albumName {};
+      std::array<char, MaxStringSize + 1> artistName {"Not Playing"};
+      // Incremented (under mutex) every time one of the strings above changes
+      std::atomic<uint32_t> generation {1};
+      SemaphoreHandle_t mutex = nullptr;
 
       bool playing {false};
 
@@ -17,6 +17,7 @@
 */
 
 #include "components/ble/NavigationService.h"
+#include <cstring>
 
 namespace {
   // 0001yyxx-78fc-48fe-8e23-433b3a1942d0
@@ -37,6 +38,12 @@ namespace {
   constexpr ble_uuid128_t navManDistCharUuid {CharUuid(0x03, 0x00)};
   constexpr ble_uuid128_t navProgressCharUuid {CharUuid(0x04, 0x00)};
 
+  template <size_t N>
+  void SetString(std::array<char, N>& destination, const char* source) {
+    std::strncpy(destination.data(), source, N - 1);
+    destination[N - 1] = '\0';
+  }
+
   int NAVCallback(uint16_t /*conn_handle*/, uint16_t /*attr_handle*/, struct ble_gatt_access_ctxt* ctxt, void* arg) {
     auto* navService = static_cast<Pinetime::Controllers::NavigationService*>(arg);
     return navService->OnCommand(ctxt);
@@ -68,6 +75,9 @@ Pinetime::Controllers::NavigationService::NavigationService() {
   serviceDefinition[1] = {0};
 
   m_progress = 0;
+
+  m_mutex = xSemaphoreCreateMutex();
+  ASSERT(m_mutex != nullptr);
 }
 
 void Pinetime::Controllers::NavigationService::Init() {
@@ -88,11 +98,20 @@ int Pinetime::Controllers::NavigationService::OnCommand(struct ble_gatt_access_c
     os_mbuf_copydata(ctxt->om, 0, notifSize, data);
     char* s = (char*) &data[0];
     if (ble_uuid_cmp(ctxt->chr->uuid, &navFlagCharUuid.u) == 0) {
-      m_flag = s;
+      xSemaphoreTake(m_mutex, portMAX_DELAY);
+      SetString(m_flag, s);
+      m_generation++;
+      xSemaphoreGive(m_mutex);
     } else if (ble_uuid_cmp(ctxt->chr->uuid, &navNarrativeCharUuid.u) == 0) {
-      m_narrative = s;
+      xSemaphoreTake(m_mutex, portMAX_DELAY);
+      SetString(m_narrative, s);
+      m_generation++;
+      xSemaphoreGive(m_mutex);
     } else if (ble_uuid_cmp(ctxt->chr->uuid, &navManDistCharUuid.u) == 0) {
-      m_manDist = s;
+      xSemaphoreTake(m_mutex, portMAX_DELAY);
+      SetString(m_manDist, s);
+      m_generation++;
+      xSemaphoreGive(m_mutex);
     } else if (ble_uuid_cmp(ctxt->chr->uuid, &navProgressCharUuid.u) == 0) {
       m_progress = data[0];
     }
@@ -100,18 +119,20 @@ int Pinetime::Controllers::NavigationService::OnCommand(struct ble_gatt_access_c
   return 0;
 }
 
-std::string Pinetime::Controllers::NavigationService::getFlag() {
-  return m_flag;
-}
-
-std::string Pinetime::Controllers::NavigationService::getNarrative() {
-  return m_narrative;
-}
-
-std::string Pinetime::Controllers::NavigationService::getManDist() {
-  return m_manDist;
+bool Pinetime::Controllers::NavigationService::getDirections(Directions& directions) const {
+  // Cheap check first, this is polled by the navigation app at every refresh
+  if (directions.generation == m_generation) {
+    return false;
+  }
+  xSemaphoreTake(m_mutex, portMAX_DELAY);
+  directions.flag = m_flag;
+  directions.narrative = m_narrative;
+  directions.manDist = m_manDist;
+  directions.generation = m_generation;
+  xSemaphoreGive(m_mutex);
+  return true;
 }
 
-int Pinetime::Controllers::NavigationService::getProgress() {
+int Pinetime::Controllers::NavigationService::getProgress() const {
   return m_progress;
 }
@@ -17,14 +17,17 @@
 */
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <cstdint>
-#include <string>
 #define min // workaround: nimble's min/max macros conflict with libstdc++
 #define max
 #include <host/ble_gap.h>
 #include <host/ble_uuid.h>
 #undef max
 #undef min
+#include <FreeRTOS.h>
+#include <semphr.h>
 
 namespace Pinetime {
   namespace Controllers {
@@ -37,21 +40,35 @@ namespace Pinetime {
 
       int OnCommand(struct ble_gatt_access_ctxt* ctxt);
 
-      std::string getFlag();
+      static constexpr size_t MaxFlagSize = 32;
+      static constexpr size_t MaxNarrativeSize = 100;
+      static constexpr size_t MaxManDistSize = 16;
 
-      std::string getNarrative();
+      struct Directions {
+        std::array<char, MaxFlagSize + 1> flag;
+        std::array<char, MaxNarrativeSize + 1> narrative;
+        std::array<char, MaxManDistSize + 1> manDist;
+        // Generation of the strings above, 0 means they were never copied
+        uint32_t generation = 0;
+      };
 
-      std::string getManDist();
+      /** Copies the flag, narrative and distance into directions if they changed since directions.generation.
+       * The copy is consistent even if the companion app is writing them at the same time.
+       * @return true if directions was updated */
+      bool getDirections(Directions& directions) const;
 
-      int getProgress();
+      int getProgress() const;
 
     private:
       struct ble_gatt_chr_def characteristicDefinition[5];
       struct ble_gatt_svc_def serviceDefinition[2];
 
-      std::string m_flag;
-      std::string m_narrative;
-      std::string m_manDist;
+      std::array<char, MaxFlagSize + 1> m_flag {};
+      std::array<char, MaxNarrativeSize + 1> m_narrative {};
+      std::array<char, MaxManDistSize + 1> m_manDist {};
+      // Incremented (under mutex) every time one of the strings above changes
+      std::atomic<uint32_t> m_generation {1};
+      SemaphoreHandle_t m_mutex = nullptr;
       int m_progress;
     };
   }
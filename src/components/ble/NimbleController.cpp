@@ -36,6 +36,7 @@ NimbleController::NimbleController(Pinetime::System::SystemTask& systemTask,
     dateTimeController {dateTimeController},
     spiNorFlash {spiNorFlash},
     fs {fs},
+    notificationScheduler {*this},
     dfuService {systemTask, bleController, spiNorFlash},
 
     currentTimeClient {dateTimeController},
@@ -92,6 +93,7 @@ void NimbleController::Init() {
   weatherService.Init();
   navService.Init();
   anService.Init();
+  notificationScheduler.Init();
   dfuService.Init();
   batteryInformationService.Init();
   immediateAlertService.Init();
@@ -206,6 +208,7 @@ int NimbleController::OnGAPEvent(ble_gap_event* event) {
         StartAdvertising();
       } else {
         connectionHandle = event->connect.conn_handle;
+        connectionParametersManager.OnConnect(connectionHandle);
         bleController.Connect();
         systemTask.PushMessage(Pinetime::System::Messages::BleConnected);
         // Service discovery is deferred via systemtask
@@ -223,6 +226,8 @@ int NimbleController::OnGAPEvent(ble_gap_event* event) {
 
       currentTimeClient.Reset();
       alertNotificationClient.Reset();
+      fsService.OnDisconnect(event->disconnect.conn.conn_handle);
+      connectionParametersManager.OnDisconnect();
       connectionHandle = BLE_HS_CONN_HANDLE_NONE;
       if (bleController.IsConnected()) {
         bleController.Disconnect();
@@ -235,6 +240,7 @@ int NimbleController::OnGAPEvent(ble_gap_event* event) {
       /* The central has updated the connection parameters. */
       NRF_LOG_INFO("Update event : BLE_GAP_EVENT_CONN_UPDATE");
       NRF_LOG_INFO("update status=%0X ", event->conn_update.status);
+      connectionParametersManager.OnConnectionUpdated(event->conn_update.conn_handle, event->conn_update.status);
       break;
 
     case BLE_GAP_EVENT_CONN_UPDATE_REQ:
@@ -399,7 +405,7 @@ uint16_t NimbleController::connHandle() {
 
 void NimbleController::NotifyBatteryLevel(uint8_t level) {
   if (connectionHandle != BLE_HS_CONN_HANDLE_NONE) {
-    batteryInformationService.NotifyBatteryLevel(connectionHandle, level);
+    batteryInformationService.NotifyBatteryLevel(notificationScheduler, level);
   }
 }
 
@@ -10,6 +10,7 @@
 #include "components/ble/AlertNotificationClient.h"
 #include "components/ble/AlertNotificationService.h"
 #include "components/ble/BatteryInformationService.h"
+#include "components/ble/ConnectionParametersManager.h"
 #include "components/ble/CurrentTimeClient.h"
 #include "components/ble/CurrentTimeService.h"
 #include "components/ble/DeviceInformationService.h"
@@ -19,6 +20,7 @@
 #include "components/ble/ImmediateAlertService.h"
 #include "components/ble/MusicService.h"
 #include "components/ble/NavigationService.h"
+#include "components/ble/NotificationScheduler.h"
 #include "components/ble/ServiceDiscovery.h"
 #include "components/ble/MotionService.h"
 #include "components/ble/SimpleWeatherService.h"
@@ -71,6 +73,14 @@ namespace Pinetime {
         return weatherService;
       };
 
+      Pinetime::Controllers::ConnectionParametersManager& connectionParameters() {
+        return connectionParametersManager;
+      };
+
+      Pinetime::Controllers::NotificationScheduler& notifications() {
+        return notificationScheduler;
+      };
+
       uint16_t connHandle();
       void NotifyBatteryLevel(uint8_t level);
 
@@ -91,6 +101,8 @@ namespace Pinetime {
       DateTime& dateTimeController;
       Pinetime::Drivers::SpiNorFlash& spiNorFlash;
       FS& fs;
+      ConnectionParametersManager connectionParametersManager;
+      NotificationScheduler notificationScheduler;
       DfuService dfuService;
 
       DeviceInformationService deviceInformationService;
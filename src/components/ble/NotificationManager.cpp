@@ -2,122 +2,178 @@
 #include <cstring>
 #include <algorithm>
 #include <cassert>
+#include "nrf_assert.h"
 
 using namespace Pinetime::Controllers;
 
 constexpr uint8_t NotificationManager::MessageSize;
 
+NotificationManager::NotificationManager() {
+  mutex = xSemaphoreCreateMutex();
+  ASSERT(mutex != nullptr);
+}
+
 void NotificationManager::Push(NotificationManager::Notification&& notif) {
-  notif.id = GetNextId();
-  notif.valid = true;
-  newNotification = true;
-  if (beginIdx > 0) {
-    --beginIdx;
-  } else {
-    beginIdx = notifications.size() - 1;
+  // Parse the title once, instead of every time the notification is displayed
+  uint8_t textSize = std::clamp<uint8_t>(notif.size, 1, MessageSize + 1);
+  notif.message[textSize - 1] = '\0';
+  const char* titleEnd = std::find(notif.message.begin(), notif.message.begin() + textSize - 1, '\0');
+  uint8_t messageOffset = 0;
+  if (titleEnd != notif.message.begin() + textSize - 1) {
+    messageOffset = static_cast<uint8_t>(titleEnd - notif.message.begin() + 1);
   }
-  notifications[beginIdx] = std::move(notif);
-  if (size < notifications.size()) {
-    size++;
+
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  // Make room by dropping the oldest notifications
+  const size_t recordSize = sizeof(RecordHeader) + textSize;
+  while (size > 0 && (size >= MaxNbNotifications || arenaUsed + recordSize > ArenaSize)) {
+    DismissIdx(size - 1);
   }
+
+  RecordHeader header {GetNextId(), static_cast<uint8_t>(notif.category), textSize, messageOffset};
+  std::memcpy(arena.data() + arenaUsed, &header, sizeof(header));
+  std::memcpy(arena.data() + arenaUsed + sizeof(header), notif.message.data(), textSize);
+  arenaUsed += recordSize;
+  size++;
+  xSemaphoreGive(mutex);
+
+  newNotification = true;
+  changeNotifier.Notify();
 }
 
 NotificationManager::Notification::Id NotificationManager::GetNextId() {
   return nextId++;
 }
 
-NotificationManager::Notification NotificationManager::GetLastNotification() const {
-  if (this->IsEmpty()) {
-    return {};
+NotificationManager::NotificationView NotificationManager::GetLastNotification() const {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  NotificationView view;
+  if (size > 0) {
+    view = this->At(0);
   }
-  return this->At(0);
+  xSemaphoreGive(mutex);
+  return view;
 }
 
-const NotificationManager::Notification& NotificationManager::At(NotificationManager::Notification::Idx idx) const {
-  if (idx >= notifications.size()) {
-    assert(false);
-    return notifications.at(beginIdx); // this should not happen
+NotificationManager::RecordHeader NotificationManager::ReadHeader(size_t offset) const {
+  RecordHeader header;
+  std::memcpy(&header, arena.data() + offset, sizeof(header));
+  return header;
+}
+
+size_t NotificationManager::RecordOffset(NotificationManager::Notification::Idx idx) const {
+  // Index 0 is the newest notification, which is the last record of the arena
+  size_t offset = 0;
+  for (size_t i = size - 1; i > idx; --i) {
+    offset += sizeof(RecordHeader) + ReadHeader(offset).textSize;
   }
-  size_t read_idx = (beginIdx + idx) % notifications.size();
-  return notifications.at(read_idx);
+  return offset;
 }
 
-NotificationManager::Notification& NotificationManager::At(NotificationManager::Notification::Idx idx) {
-  if (idx >= notifications.size()) {
+NotificationManager::NotificationView NotificationManager::At(NotificationManager::Notification::Idx idx) const {
+  if (idx >= size) {
     assert(false);
-    return notifications.at(beginIdx); // this should not happen
+    return {}; // this should not happen
+  }
+  size_t offset = RecordOffset(idx);
+  RecordHeader header = ReadHeader(offset);
+
+  NotificationView view;
+  view.id = header.id;
+  view.category = static_cast<Categories>(header.category);
+  view.valid = true;
+  return view;
+}
+
+bool NotificationManager::CopyText(NotificationManager::Notification::Id id, NotificationManager::NotificationText& text) const {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  NotificationManager::Notification::Idx idx = this->FindIdx(id);
+  bool found = idx != this->size;
+  if (found) {
+    size_t offset = RecordOffset(idx);
+    RecordHeader header = ReadHeader(offset);
+    std::memcpy(text.text.data(), arena.data() + offset + sizeof(RecordHeader), header.textSize);
+    text.messageOffset = header.messageOffset;
   }
-  size_t read_idx = (beginIdx + idx) % notifications.size();
-  return notifications.at(read_idx);
+  xSemaphoreGive(mutex);
+  return found;
 }
 
 NotificationManager::Notification::Idx NotificationManager::IndexOf(NotificationManager::Notification::Id id) const {
-  for (NotificationManager::Notification::Idx idx = 0; idx < this->size; idx++) {
-    const NotificationManager::Notification& notification = this->At(idx);
-    if (notification.id == id) {
-      return idx;
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  Notification::Idx idx = FindIdx(id);
+  xSemaphoreGive(mutex);
+  return idx;
+}
+
+NotificationManager::Notification::Idx NotificationManager::FindIdx(NotificationManager::Notification::Id id) const {
+  size_t offset = 0;
+  for (size_t i = size; i > 0; --i) {
+    RecordHeader header = ReadHeader(offset);
+    if (header.id == id) {
+      return i - 1;
     }
+    offset += sizeof(RecordHeader) + header.textSize;
   }
   return size;
 }
 
-NotificationManager::Notification NotificationManager::Get(NotificationManager::Notification::Id id) const {
-  NotificationManager::Notification::Idx idx = this->IndexOf(id);
-  if (idx == this->size) {
-    return {};
+NotificationManager::NotificationView NotificationManager::Get(NotificationManager::Notification::Id id) const {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  NotificationView view;
+  NotificationManager::Notification::Idx idx = this->FindIdx(id);
+  if (idx != this->size) {
+    view = this->At(idx);
   }
-  return this->At(idx);
+  xSemaphoreGive(mutex);
+  return view;
 }
 
-NotificationManager::Notification NotificationManager::GetNext(NotificationManager::Notification::Id id) const {
-  NotificationManager::Notification::Idx idx = this->IndexOf(id);
-  if (idx == this->size) {
-    return {};
-  }
-  if (idx == 0 || idx > notifications.size()) {
-    return {};
+NotificationManager::NotificationView NotificationManager::GetNext(NotificationManager::Notification::Id id) const {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  NotificationView view;
+  NotificationManager::Notification::Idx idx = this->FindIdx(id);
+  if (idx != this->size && idx != 0) {
+    view = this->At(idx - 1);
   }
-  return this->At(idx - 1);
+  xSemaphoreGive(mutex);
+  return view;
 }
 
-NotificationManager::Notification NotificationManager::GetPrevious(NotificationManager::Notification::Id id) const {
-  NotificationManager::Notification::Idx idx = this->IndexOf(id);
-  if (idx == this->size) {
-    return {};
+NotificationManager::NotificationView NotificationManager::GetPrevious(NotificationManager::Notification::Id id) const {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  NotificationView view;
+  NotificationManager::Notification::Idx idx = this->FindIdx(id);
+  if (idx != this->size && static_cast<size_t>(idx + 1) < size) {
+    view = this->At(idx + 1);
   }
-  if (static_cast<size_t>(idx + 1) >= notifications.size()) {
-    return {};
-  }
-  return this->At(idx + 1);
+  xSemaphoreGive(mutex);
+  return view;
 }
 
 void NotificationManager::DismissIdx(NotificationManager::Notification::Idx idx) {
-  if (this->IsEmpty()) {
+  if (size == 0) {
     return;
   }
   if (idx >= size) {
     assert(false);
     return; // this should not happen
   }
-  if (idx == 0) { // just remove the first element, don't need to change the other elements
-    notifications.at(beginIdx).valid = false;
-    beginIdx = (beginIdx + 1) % notifications.size();
-  } else {
-    // overwrite the specified entry by moving all later messages one index to the front
-    for (size_t i = idx; i < size - 1; ++i) {
-      this->At(i) = this->At(i + 1);
-    }
-    this->At(size - 1).valid = false;
-  }
+  // Move all the newer records over the dismissed one, the arena is small enough for this to be cheap
+  size_t offset = RecordOffset(idx);
+  size_t recordSize = sizeof(RecordHeader) + ReadHeader(offset).textSize;
+  std::memmove(arena.data() + offset, arena.data() + offset + recordSize, arenaUsed - offset - recordSize);
+  arenaUsed -= recordSize;
   --size;
 }
 
 void NotificationManager::Dismiss(NotificationManager::Notification::Id id) {
-  NotificationManager::Notification::Idx idx = this->IndexOf(id);
-  if (idx == this->size) {
-    return;
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  NotificationManager::Notification::Idx idx = this->FindIdx(id);
+  if (idx != this->size) {
+    this->DismissIdx(idx);
   }
-  this->DismissIdx(idx);
+  xSemaphoreGive(mutex);
 }
 
 bool NotificationManager::AreNewNotificationsAvailable() const {
@@ -125,26 +181,20 @@ bool NotificationManager::AreNewNotificationsAvailable() const {
 }
 
 bool NotificationManager::ClearNewNotificationFlag() {
-  return newNotification.exchange(false);
-}
-
-size_t NotificationManager::NbNotifications() const {
-  return size;
+  bool wasSet = newNotification.exchange(false);
+  if (wasSet) {
+    changeNotifier.Notify();
+  }
+  return wasSet;
 }
 
-const char* NotificationManager::Notification::Message() const {
-  const char* itField = std::find(message.begin(), message.begin() + size - 1, '\0');
-  if (itField != message.begin() + size - 1) {
-    const char* ptr = (itField) + 1;
-    return ptr;
-  }
-  return const_cast<char*>(message.data());
+bool NotificationManager::IsEmpty() const {
+  return NbNotifications() == 0;
 }
 
-const char* NotificationManager::Notification::Title() const {
-  const char* itField = std::find(message.begin(), message.begin() + size - 1, '\0');
-  if (itField != message.begin() + size - 1) {
-    return message.data();
-  }
-  return {};
+size_t NotificationManager::NbNotifications() const {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  size_t count = size;
+  xSemaphoreGive(mutex);
+  return count;
 }
@@ -4,6 +4,9 @@
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <FreeRTOS.h>
+#include <semphr.h>
+#include "utility/DataChangeNotifier.h"
 
 namespace Pinetime {
   namespace Controllers {
@@ -24,25 +27,52 @@ namespace Pinetime {
       };
       static constexpr uint8_t MessageSize {100};
 
+      // Notification as received from the companion app, only used to push it to the manager
       struct Notification {
         using Id = uint8_t;
         using Idx = uint8_t;
 
-        std::array<char, MessageSize + 1> message{};
+        std::array<char, MessageSize + 1> message {};
         uint8_t size;
         Categories category = Categories::Unknown;
         Id id = 0;
         bool valid = false;
+      };
+
+      // Stored notification, without its text: see CopyText()
+      struct NotificationView {
+        Notification::Id id = 0;
+        Categories category = Categories::Unknown;
+        bool valid = false;
+      };
+
+      // Notifications are pushed from the BLE task and the records are moved in the arena when one is dismissed, so
+      // the text is copied out of the arena instead of pointing into it. Only the screen that displays a notification
+      // needs it.
+      struct NotificationText {
+        const char* Message() const {
+          return text.data() + messageOffset;
+        }
 
-        const char* Message() const;
-        const char* Title() const;
+        // nullptr if the notification has no title
+        const char* Title() const {
+          return (messageOffset != 0) ? text.data() : nullptr;
+        }
+
+        // Title and message separated by a null character
+        std::array<char, MessageSize + 1> text {};
+        uint8_t messageOffset = 0;
       };
 
+      NotificationManager();
+
       void Push(Notification&& notif);
-      Notification GetLastNotification() const;
-      Notification Get(Notification::Id id) const;
-      Notification GetNext(Notification::Id id) const;
-      Notification GetPrevious(Notification::Id id) const;
+      NotificationView GetLastNotification() const;
+      NotificationView Get(Notification::Id id) const;
+      NotificationView GetNext(Notification::Id id) const;
+      NotificationView GetPrevious(Notification::Id id) const;
+      // Return false if there is no notification with this id anymore
+      bool CopyText(Notification::Id id, NotificationText& text) const;
       // Return the index of the notification with the specified id, if not found return NbNotifications()
       Notification::Idx IndexOf(Notification::Id id) const;
       bool ClearNewNotificationFlag();
@@ -53,25 +83,43 @@ namespace Pinetime {
         return MessageSize;
       };
 
-      bool IsEmpty() const {
-        return size == 0;
-      }
-
+      bool IsEmpty() const;
       size_t NbNotifications() const;
 
+      void Subscribe(Utility::DataChangeListener* listener) {
+        changeNotifier.Subscribe(listener);
+      }
+
     private:
+      // Notifications are stored back to back in the arena, oldest first, each one as a RecordHeader followed by
+      // its text (title and message separated by a null character). Records only take the space their text needs,
+      // so short notifications leave room for more of them.
+      struct RecordHeader {
+        Notification::Id id;
+        uint8_t category;      // Categories, stored on 1 byte
+        uint8_t textSize;      // Size of the text, including the terminating null character
+        uint8_t messageOffset; // Offset of the message in the text, 0 if there is no title
+      };
+
+      static constexpr size_t ArenaSize = 512;
+      static constexpr uint8_t MaxNbNotifications = 16;
+
       Notification::Id nextId {0};
       Notification::Id GetNextId();
-      const Notification& At(Notification::Idx idx) const;
-      Notification& At(Notification::Idx idx);
+      RecordHeader ReadHeader(size_t offset) const;
+      size_t RecordOffset(Notification::Idx idx) const;
+      Notification::Idx FindIdx(Notification::Id id) const;
+      NotificationView At(Notification::Idx idx) const;
       void DismissIdx(Notification::Idx idx);
 
-      static constexpr uint8_t TotalNbNotifications = 5;
-      std::array<Notification, TotalNbNotifications> notifications;
-      size_t beginIdx = TotalNbNotifications - 1; // index of the newest notification
-      size_t size = 0;                            // number of valid notifications in buffer
+      std::array<char, ArenaSize> arena {};
+      size_t arenaUsed = 0; // bytes used by the records
+      size_t size = 0;      // number of notifications in the arena
+      // Guards the arena, Push() is called from the BLE task while the display task reads the notifications
+      mutable SemaphoreHandle_t mutex = nullptr;
 
       std::atomic<bool> newNotification {false};
+      Utility::DataChangeNotifier changeNotifier {Utility::DataSource::Notifications};
     };
   }
 }
@@ -0,0 +1,113 @@
+#include "components/ble/NotificationScheduler.h"
+#include <cstring>
+#include "components/ble/NimbleController.h"
+
+using namespace Pinetime::Controllers;
+
+NotificationScheduler::NotificationScheduler(NimbleController& nimble) : nimble {nimble} {
+  mutex = xSemaphoreCreateMutex();
+  ASSERT(mutex != nullptr);
+}
+
+void NotificationScheduler::Init() {
+  ble_npl_event_init(&event, OnEvent, this);
+  ble_npl_callout_init(&retryCallout, nimble_port_get_dflt_eventq(), OnEvent, this);
+}
+
+void NotificationScheduler::Schedule(uint16_t attributeHandle, const void* value, size_t size) {
+  ASSERT(size <= MaxValueSize);
+
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  Slot* slot = nullptr;
+  for (auto& s : slots) {
+    if (s.attributeHandle == attributeHandle) {
+      slot = &s;
+      break;
+    }
+  }
+  if (slot == nullptr) {
+    for (auto& s : slots) {
+      if (!s.pending) {
+        slot = &s;
+        break;
+      }
+    }
+  }
+  if (slot == nullptr) {
+    stats.dropped++;
+    xSemaphoreGive(mutex);
+    return;
+  }
+
+  if (slot->pending && slot->attributeHandle == attributeHandle) {
+    stats.coalesced++;
+  }
+  slot->attributeHandle = attributeHandle;
+  slot->pending = true;
+  slot->size = size;
+  std::memcpy(slot->value.data(), value, size);
+  xSemaphoreGive(mutex);
+
+  // The link is congested: the value is sent by the retry callout. Otherwise, does nothing if the event is already queued
+  if (!ble_npl_callout_is_active(&retryCallout)) {
+    ble_npl_eventq_put(nimble_port_get_dflt_eventq(), &event);
+  }
+}
+
+NotificationScheduler::Stats NotificationScheduler::GetStats() const {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  Stats copy = stats;
+  xSemaphoreGive(mutex);
+  return copy;
+}
+
+void NotificationScheduler::OnEvent(ble_npl_event* event) {
+  auto* scheduler = static_cast<NotificationScheduler*>(ble_npl_event_get_arg(event));
+  scheduler->Send();
+}
+
+// Runs in the NimBLE host task
+void NotificationScheduler::Send() {
+  uint16_t connectionHandle = nimble.connHandle();
+  bool congested = false;
+
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  for (auto& slot : slots) {
+    if (!slot.pending) {
+      continue;
+    }
+    if (connectionHandle == 0 || connectionHandle == BLE_HS_CONN_HANDLE_NONE) {
+      slot.pending = false;
+      stats.dropped++;
+      continue;
+    }
+    if (os_msys_num_free() < minFreeMbufs) {
+      congested = true;
+      break;
+    }
+
+    auto* om = ble_hs_mbuf_from_flat(slot.value.data(), slot.size);
+    if (om == nullptr) {
+      congested = true;
+      break;
+    }
+    int res = ble_gattc_notify_custom(connectionHandle, slot.attributeHandle, om);
+    if (res == BLE_HS_ENOMEM) {
+      congested = true;
+      break;
+    }
+    slot.pending = false;
+    if (res == 0) {
+      stats.sent++;
+    } else {
+      stats.dropped++;
+    }
+  }
+  xSemaphoreGive(mutex);
+
+  // The pending values stay in their slot, and are replaced if newer ones are scheduled in the meantime.
+  // NimBLE doesn't report when the mbufs are freed (NOTIFY_TX is raised as soon as the notification is queued).
+  if (congested) {
+    ble_npl_callout_reset(&retryCallout, ble_npl_time_ms_to_ticks32(retryDelayMs));
+  }
+}
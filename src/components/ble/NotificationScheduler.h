@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#define min // workaround: nimble's min/max macros conflict with libstdc++
+#define max
+#include <nimble/nimble_port.h>
+#undef max
+#undef min
+#include <FreeRTOS.h>
+#include <semphr.h>
+
+namespace Pinetime {
+  namespace Controllers {
+    class NimbleController;
+
+    /** Sends the notifications of the characteristics that are updated periodically (motion, heart rate, battery...).
+     * Schedule() only stores the latest value of the characteristic: all the pending values are sent together from
+     * the NimBLE host task, so they go out in the same connection event. When the link is congested, a newer value
+     * replaces the pending one instead of queuing up, and no mbuf is allocated until the value can actually be sent. */
+    class NotificationScheduler {
+    public:
+      static constexpr size_t MaxValueSize = 8;
+
+      struct Stats {
+        uint32_t sent;
+        // Values replaced by a newer one before they could be sent
+        uint32_t coalesced;
+        // Values that were never sent: no free slot, disconnected or send error
+        uint32_t dropped;
+      };
+
+      explicit NotificationScheduler(NimbleController& nimble);
+      void Init();
+
+      /** Schedules a notification of the characteristic with the given value, replacing the pending one if any.
+       * Can be called from any task. */
+      void Schedule(uint16_t attributeHandle, const void* value, size_t size);
+
+      Stats GetStats() const;
+
+    private:
+      struct Slot {
+        uint16_t attributeHandle = 0;
+        bool pending = false;
+        uint8_t size = 0;
+        std::array<uint8_t, MaxValueSize> value;
+      };
+
+      static constexpr size_t NbSlots = 6;
+      // Keep this many mbufs for the other services and for incoming data
+      static constexpr int minFreeMbufs = 4;
+      static constexpr uint32_t retryDelayMs = 50;
+
+      static void OnEvent(ble_npl_event* event);
+      void Send();
+
+      NimbleController& nimble;
+      std::array<Slot, NbSlots> slots;
+      SemaphoreHandle_t mutex;
+      ble_npl_event event;
+      ble_npl_callout retryCallout;
+      Stats stats {};
+    };
+  }
+}
@@ -142,6 +142,7 @@ int SimpleWeatherService::OnCommand(struct ble_gatt_access_ctxt* ctxt) {
         if (GetVersion(dataBuffer) == 1) {
           NRF_LOG_INFO("Sunrise: %d\n\tSunset: %d", currentWeather->sunrise, currentWeather->sunset);
         }
+        changeNotifier.Notify();
       }
       break;
     case MessageType::Forecast:
@@ -155,6 +156,7 @@ int SimpleWeatherService::OnCommand(struct ble_gatt_access_ctxt* ctxt) {
                        forecast->days[i]->maxTemperature.PreciseCelsius(),
                        forecast->days[i]->iconId);
         }
+        changeNotifier.Notify();
       }
       break;
     default:
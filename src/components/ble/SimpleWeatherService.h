@@ -35,6 +35,7 @@
 #include <lvgl/lvgl.h>
 #include "displayapp/InfiniTimeTheme.h"
 #include "utility/Math.h"
+#include "utility/DataChangeNotifier.h"
 
 int WeatherCallback(uint16_t connHandle, uint16_t attrHandle, struct ble_gatt_access_ctxt* ctxt, void* arg);
 
@@ -160,6 +161,10 @@ namespace Pinetime {
 
       [[nodiscard]] bool IsNight() const;
 
+      void Subscribe(Utility::DataChangeListener* listener) {
+        changeNotifier.Subscribe(listener);
+      }
+
     private:
       // 00050000-78fc-48fe-8e23-433b3a1942d0
       static constexpr ble_uuid128_t BaseUuid() {
@@ -192,6 +197,8 @@ namespace Pinetime {
 
       std::optional<CurrentWeather> currentWeather;
       std::optional<Forecast> forecast;
+
+      Utility::DataChangeNotifier changeNotifier {Utility::DataSource::Weather};
     };
   }
 }
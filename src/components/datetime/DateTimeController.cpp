@@ -39,6 +39,7 @@ void DateTime::SetCurrentTime(std::chrono::time_point<std::chrono::system_clock,
   this->currentDateTime = t;
   UpdateTime(previousSystickCounter, true); // Update internal state without updating the time
   xSemaphoreGive(mutex);
+  changeNotifier.Notify();
 }
 
 void DateTime::SetTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute, uint8_t second) {
@@ -64,11 +65,13 @@ void DateTime::SetTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour,
   if (systemTask != nullptr) {
     systemTask->PushMessage(System::Messages::OnNewTime);
   }
+  changeNotifier.Notify();
 }
 
 void DateTime::SetTimeZone(int8_t timezone, int8_t dst) {
   tzOffset = timezone;
   dstOffset = dst;
+  changeNotifier.Notify();
 }
 
 std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds> DateTime::CurrentDateTime() {
@@ -78,6 +81,21 @@ std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds> Dat
   return currentDateTime;
 }
 
+TickType_t DateTime::TicksUntilNextSecond() {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  uint32_t systickCounter = nrf_rtc_counter_get(portNRF_RTC_REG);
+  UpdateTime(systickCounter, false);
+  // previousSystickCounter is aligned on the last second boundary, the RTC counter is 24 bits wide
+  uint32_t ticksIntoSecond = (systickCounter - previousSystickCounter) & portNRF_RTC_MAXTICKS;
+  xSemaphoreGive(mutex);
+  return configTICK_RATE_HZ - ticksIntoSecond;
+}
+
+TickType_t DateTime::TicksUntilNextMinute() {
+  TickType_t ticks = TicksUntilNextSecond();
+  return ticks + (59 - Seconds()) * configTICK_RATE_HZ;
+}
+
 void DateTime::UpdateTime(uint32_t systickCounter, bool forceUpdate) {
   // Handle systick counter overflow
   uint32_t systickDelta = 0;
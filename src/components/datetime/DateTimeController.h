@@ -7,6 +7,7 @@
 #include "components/settings/Settings.h"
 #include <FreeRTOS.h>
 #include <semphr.h>
+#include "utility/DataChangeNotifier.h"
 
 namespace Pinetime {
   namespace System {
@@ -136,7 +137,22 @@ namespace Pinetime {
         return uptime;
       }
 
+      /*
+       * returns the number of system ticks left until the next second (or minute) starts.
+       *
+       * Screens use this to wake up exactly when the displayed time changes
+       * instead of polling CurrentDateTime().
+       */
+      TickType_t TicksUntilNextSecond();
+      TickType_t TicksUntilNextMinute();
+
       void Register(System::SystemTask* systemTask);
+
+      // Notified when the time is set or the time zone changes, not when it ticks
+      void Subscribe(Utility::DataChangeListener* listener) {
+        changeNotifier.Subscribe(listener);
+      }
+
       void SetCurrentTime(std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds> t);
       std::string FormattedTime();
 
@@ -158,6 +174,7 @@ namespace Pinetime {
       bool isHalfHourAlreadyNotified = true;
       System::SystemTask* systemTask = nullptr;
       Controllers::Settings& settingsController;
+      Utility::DataChangeNotifier changeNotifier {Utility::DataSource::Time};
     };
   }
 }
@@ -0,0 +1,155 @@
+#include "components/fs/AssetPartition.h"
+#include <algorithm>
+#include <cstring>
+#include <crc32.h>
+#include <libraries/log/nrf_log.h>
+
+using namespace Pinetime::Controllers;
+
+AssetPartition::AssetPartition(Pinetime::Drivers::SpiNorFlash& flashDriver,
+                               FlashReadCache& readCache,
+                               uint32_t startAddress,
+                               uint32_t size)
+  : flashDriver {flashDriver}, readCache {readCache}, startAddress {startAddress}, size {size} {
+}
+
+uint32_t AssetPartition::Hash(const char* path) {
+  // FNV-1a, the same function is implemented in generate-package.py
+  uint32_t hash = 0x811C9DC5;
+  for (; *path != '\0'; path++) {
+    hash ^= static_cast<uint8_t>(*path);
+    hash *= 0x01000193;
+  }
+  return hash;
+}
+
+bool AssetPartition::IsCompatible(const Header& header) const {
+  return header.magic == magic && header.version == version && header.nbBuckets > 0 && header.nbBuckets <= maxBuckets &&
+         (header.nbBuckets & (header.nbBuckets - 1)) == 0 && header.imageSize <= size &&
+         header.imageSize >= sizeof(Header) + header.nbBuckets * sizeof(Bucket);
+}
+
+bool AssetPartition::IsValid(const Bucket& bucket, uint32_t imageSize) const {
+  return bucket.hash == 0 || (bucket.offset <= imageSize && bucket.size <= imageSize - bucket.offset && bucket.nameLength > 0 &&
+                              bucket.nameLength <= maxNameLength && bucket.nameOffset + bucket.nameLength <= imageSize);
+}
+
+bool AssetPartition::Load() {
+  Disable();
+  Header header;
+  readCache.Read(startAddress, reinterpret_cast<uint8_t*>(&header), sizeof(Header));
+  if (!IsCompatible(header)) {
+    return false;
+  }
+  // The header is written last, but the data may have been damaged since
+  const uint32_t crc = ImageCrc(header);
+  if (crc != header.crc) {
+    NRF_LOG_INFO("[Assets] Invalid image, CRC %08x instead of %08x", crc, header.crc);
+    return false;
+  }
+
+  nbBuckets = header.nbBuckets;
+  readCache.Read(startAddress + sizeof(Header), reinterpret_cast<uint8_t*>(buckets.data()), nbBuckets * sizeof(Bucket));
+  for (uint16_t i = 0; i < nbBuckets; i++) {
+    if (!IsValid(buckets[i], header.imageSize)) {
+      return false;
+    }
+  }
+  valid = true;
+  return true;
+}
+
+void AssetPartition::Disable() {
+  valid = false;
+  generation++;
+}
+
+bool AssetPartition::Find(const char* path, Asset& asset) const {
+  if (!valid) {
+    return false;
+  }
+  const uint32_t hash = Hash(path);
+  const size_t length = strlen(path);
+  const uint16_t mask = nbBuckets - 1;
+  for (uint16_t i = 0; i < nbBuckets; i++) {
+    const Bucket& bucket = buckets[(hash + i) & mask];
+    if (bucket.hash == 0) {
+      return false;
+    }
+    if (bucket.hash != hash || bucket.nameLength != length) {
+      continue;
+    }
+    // Another path may have the same hash
+    char name[maxNameLength];
+    readCache.Read(startAddress + bucket.nameOffset, reinterpret_cast<uint8_t*>(name), bucket.nameLength);
+    if (std::memcmp(name, path, length) == 0) {
+      asset.address = startAddress + bucket.offset;
+      asset.size = bucket.size;
+      asset.generation = generation;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool AssetPartition::Name(uint16_t index, char (&name)[maxNameLength + 1]) const {
+  if (!valid || index >= nbBuckets || buckets[index].hash == 0) {
+    return false;
+  }
+  readCache.Read(startAddress + buckets[index].nameOffset, reinterpret_cast<uint8_t*>(name), buckets[index].nameLength);
+  name[buckets[index].nameLength] = '\0';
+  return true;
+}
+
+uint32_t AssetPartition::Read(const Asset& asset, uint32_t offset, uint8_t* buffer, uint32_t size) {
+  // The asset may have been erased or moved by the installation of a new image
+  if (!valid || asset.generation != generation || offset >= asset.size) {
+    return 0;
+  }
+  size = std::min(size, asset.size - offset);
+  readCache.Read(asset.address + offset, buffer, size);
+  return size;
+}
+
+void AssetPartition::Erase(const Header& header) {
+  const uint32_t end = startAddress + header.imageSize;
+  uint32_t address = startAddress;
+  while (address < end) {
+    address += flashDriver.EraseSpan(address, end);
+  }
+}
+
+void AssetPartition::Write(uint32_t offset, const uint8_t* data, size_t size) {
+  // The header is written last, by Commit()
+  if (offset < sizeof(Header)) {
+    const size_t skip = std::min(size, sizeof(Header) - offset);
+    offset += skip;
+    data += skip;
+    size -= skip;
+  }
+  if (size > 0) {
+    flashDriver.Write(startAddress + offset, data, size);
+  }
+}
+
+uint32_t AssetPartition::ImageCrc(const Header& header) const {
+  // Read directly from the flash, the image would evict everything else from the read cache
+  uint8_t buffer[64];
+  uint32_t crc = 0;
+  for (uint32_t offset = sizeof(Header); offset < header.imageSize; offset += sizeof(buffer)) {
+    const uint32_t count = std::min<uint32_t>(sizeof(buffer), header.imageSize - offset);
+    flashDriver.Read(startAddress + offset, buffer, count);
+    crc = (offset == sizeof(Header)) ? crc32_compute(buffer, count, nullptr) : crc32_compute(buffer, count, &crc);
+  }
+  return crc;
+}
+
+bool AssetPartition::Commit(const Header& header) {
+  const uint32_t crc = ImageCrc(header);
+  if (crc != header.crc) {
+    NRF_LOG_INFO("[Assets] CRC mismatch : %08x instead of %08x", crc, header.crc);
+    return false;
+  }
+  flashDriver.Write(startAddress, reinterpret_cast<const uint8_t*>(&header), sizeof(Header));
+  return !flashDriver.ProgramFailed();
+}
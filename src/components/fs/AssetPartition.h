@@ -0,0 +1,103 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "drivers/SpiNorFlash.h"
+#include "components/fs/FlashReadCache.h"
+
+namespace Pinetime {
+  namespace Controllers {
+    /** Read-only region of the external flash that contains the fonts and images of the resource package.
+     *
+     * The image is generated by src/resources/generate-package.py : a header, a hash table of the assets (FNV-1a of
+     * their path, linear probing), their paths and their content, each of them aligned on a flash page. The hash
+     * table is loaded in RAM, so opening an asset only reads its path to rule out a collision, and reading it is a
+     * direct read at its offset.
+     *
+     * The image is received as a regular file (FS::assetImagePath) and copied here by FS::InstallAssets().
+     * This class is not thread safe, the calls are serialized by FS. */
+    class AssetPartition {
+    public:
+      struct Asset {
+        uint32_t address = 0;
+        uint32_t size = 0;
+        // Generation of the partition when the asset was opened, the asset can't be read once it changes
+        uint32_t generation = 0;
+      };
+
+      struct Header {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t nbBuckets;
+        uint32_t imageSize;
+        // CRC32 of the image after the header
+        uint32_t crc;
+      };
+
+      struct Bucket {
+        // 0 if the bucket is empty
+        uint32_t hash;
+        // From the start of the image
+        uint32_t offset;
+        uint32_t size;
+        // Path of the asset, from the start of the image, without null terminator
+        uint16_t nameOffset;
+        uint8_t nameLength;
+        uint8_t reserved;
+      };
+
+      static constexpr uint32_t magic = 0x53415450; // "PTAS"
+      static constexpr uint16_t version = 2;
+      static constexpr uint16_t maxBuckets = 32;
+      static constexpr uint8_t maxNameLength = 64;
+
+      AssetPartition(Pinetime::Drivers::SpiNorFlash& flashDriver, FlashReadCache& readCache, uint32_t startAddress, uint32_t size);
+
+      // Verifies the CRC of the installed image and loads its hash table, return false if there is no valid image
+      bool Load();
+      // The assets opened before can't be read anymore
+      void Disable();
+
+      bool IsValid() const {
+        return valid;
+      }
+
+      bool IsCompatible(const Header& header) const;
+      bool IsValid(const Bucket& bucket, uint32_t imageSize) const;
+      bool Find(const char* path, Asset& asset) const;
+      // Return the number of bytes read, which is less than size at the end of the asset.
+      // Return 0 if the partition was disabled or reloaded since the asset was opened.
+      uint32_t Read(const Asset& asset, uint32_t offset, uint8_t* buffer, uint32_t size);
+
+      uint16_t NbBuckets() const {
+        return valid ? nbBuckets : 0;
+      }
+
+      // Copies the null terminated path of the asset of a bucket, return false if the bucket is empty
+      bool Name(uint16_t index, char (&name)[maxNameLength + 1]) const;
+
+      // Installation of a new image : the partition must be disabled first. The data after the header is written
+      // with Write(), and the header is written by Commit() once the CRC of the data is verified, so that an
+      // interrupted installation leaves no valid image.
+      void Erase(const Header& header);
+      void Write(uint32_t offset, const uint8_t* data, size_t size);
+      bool Commit(const Header& header);
+
+      static uint32_t Hash(const char* path);
+
+    private:
+      uint32_t ImageCrc(const Header& header) const;
+
+      Pinetime::Drivers::SpiNorFlash& flashDriver;
+      FlashReadCache& readCache;
+      const uint32_t startAddress;
+      const uint32_t size;
+
+      bool valid = false;
+      uint32_t generation = 0;
+      uint16_t nbBuckets = 0;
+      std::array<Bucket, maxBuckets> buckets;
+    };
+  }
+}
@@ -1,18 +1,25 @@
 #include "components/fs/FS.h"
+#include <algorithm>
 #include <cstring>
 #include <littlefs/lfs.h>
+#include <libraries/log/nrf_log.h>
 #include <lvgl/lvgl.h>
+#include "nrf_assert.h"
 
 using namespace Pinetime::Controllers;
 
 FS::FS(Pinetime::Drivers::SpiNorFlash& driver)
   : flashDriver {driver},
+    readCache {driver},
+    assets {driver, readCache, assetsAddress, assetsSize},
     lfsConfig {
       .context = this,
       .read = SectorRead,
       .prog = SectorProg,
       .erase = SectorErase,
       .sync = SectorSync,
+      .lock = Lock,
+      .unlock = Unlock,
 
       .read_size = 16,
       .prog_size = 8,
@@ -26,31 +33,134 @@ FS::FS(Pinetime::Drivers::SpiNorFlash& driver)
       .name_max = 50,
       .attr_max = 50,
     } {
+  mutex = xSemaphoreCreateMutex();
+  ASSERT(mutex != nullptr);
+  resourceMutex = xSemaphoreCreateMutex();
+  ASSERT(resourceMutex != nullptr);
 }
 
 void FS::Init() {
-
-  // try mount
-  int err = lfs_mount(&lfs, &lfsConfig);
+  int err = Mount();
 
   // reformat if we can't mount the filesystem
   // this should only happen on the first boot
   if (err != LFS_ERR_OK) {
+    legacyLayout = false;
+    lfsConfig.block_count = size / blockSize;
     lfs_format(&lfs, &lfsConfig);
     err = lfs_mount(&lfs, &lfsConfig);
     if (err != LFS_ERR_OK) {
       return;
     }
+    lfs_setattr(&lfs, "/", layoutAttribute, &assetsLayout, sizeof(assetsLayout));
+  }
+
+  if (!legacyLayout) {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    assets.Load();
+    xSemaphoreGive(mutex);
   }
 
 #ifndef PINETIME_IS_RECOVERY
+  // An image received just before a reset has not been installed yet
+  lfs_info info;
+  if (Stat(assetImagePath, &info) == LFS_ERR_OK) {
+    InstallAssets();
+  }
   VerifyResource();
 #endif
+
+  // The mount and the checks at boot are not counted
+  stats.maxLockTime = 0;
+}
+
+int FS::Mount() {
+  // Mount with the legacy geometry first : it covers both layouts, so no block outside of the filesystem is read.
+  // Depending on its version, littlefs refuses to mount if the block count is not the one of the superblock.
+  legacyLayout = true;
+  lfsConfig.block_count = legacySize / blockSize;
+  int err = lfs_mount(&lfs, &lfsConfig);
+  if (err == LFS_ERR_OK) {
+    uint8_t layout = 0;
+    if (lfs_getattr(&lfs, "/", layoutAttribute, &layout, sizeof(layout)) != sizeof(layout) || layout != assetsLayout) {
+      NRF_LOG_INFO("[FS] Legacy layout, no asset partition");
+      return LFS_ERR_OK;
+    }
+    // A previous firmware may have used the whole area since the format, the filesystem then keeps it
+    lfs_block_t maxBlock = 0;
+    lfs_fs_traverse(
+      &lfs,
+      [](void* data, lfs_block_t block) {
+        auto* max = static_cast<lfs_block_t*>(data);
+        *max = std::max(*max, block);
+        return 0;
+      },
+      &maxBlock);
+    if (maxBlock >= size / blockSize) {
+      NRF_LOG_INFO("[FS] Blocks used in the asset partition, legacy layout");
+      return LFS_ERR_OK;
+    }
+    lfs_unmount(&lfs);
+  }
+
+  legacyLayout = false;
+  lfsConfig.block_count = size / blockSize;
+  err = lfs_mount(&lfs, &lfsConfig);
+  if (err == LFS_ERR_OK) {
+    uint8_t layout = 0;
+    if (lfs_getattr(&lfs, "/", layoutAttribute, &layout, sizeof(layout)) != sizeof(layout) || layout != assetsLayout) {
+      // Not formatted by this version, this filesystem could use the blocks of the asset partition
+      lfs_unmount(&lfs);
+      return LFS_ERR_CORRUPT;
+    }
+  }
+  return err;
 }
 
 void FS::VerifyResource() {
-  // validate the resource metadata
-  resourcesValid = true;
+  // The index is rebuilt in place : the availability checks wait for the end of the verification
+  xSemaphoreTake(resourceMutex, portMAX_DELAY);
+  nbResources = 0;
+  resourcesValid = false;
+
+  lfs_file_t file;
+  if (FileOpen(&file, resourceManifestPath, LFS_O_RDONLY) == LFS_ERR_OK) {
+    ManifestHeader header;
+    if (FileRead(&file, reinterpret_cast<uint8_t*>(&header), sizeof(header)) == sizeof(header) && header.magic == manifestMagic &&
+        header.version == manifestVersion) {
+      resourcesValid = true;
+      for (uint16_t i = 0; i < header.nbResources; i++) {
+        ManifestEntry entry;
+        char path[maxResourcePathLength + 1];
+        if (FileRead(&file, reinterpret_cast<uint8_t*>(&entry), sizeof(entry)) != sizeof(entry) ||
+            entry.pathLength > maxResourcePathLength ||
+            FileRead(&file, reinterpret_cast<uint8_t*>(path), entry.pathLength) != entry.pathLength) {
+          NRF_LOG_INFO("[FS] Invalid resource manifest");
+          resourcesValid = false;
+          nbResources = 0;
+          break;
+        }
+        path[entry.pathLength] = '\0';
+        if (nbResources == maxResources) {
+          // The other resources are checked on the filesystem
+          NRF_LOG_INFO("[FS] Too many resources in the manifest");
+          break;
+        }
+        resources[nbResources++] = {AssetPartition::Hash(path), ResourceInstalled(path, entry.size)};
+      }
+    }
+    FileClose(&file);
+  }
+  xSemaphoreGive(resourceMutex);
+}
+
+bool FS::ResourceInstalled(const char* path, uint32_t size) {
+  AssetPartition::Asset asset;
+  if (AssetOpen(path, asset) && asset.size == size) {
+    return true;
+  }
+  lfs_info info;
+  return Stat(path, &info) == LFS_ERR_OK && info.type == LFS_TYPE_REG && info.size == size;
 }
 
 int FS::FileOpen(lfs_file_t* file_p, const char* fileName, const int flags) {
@@ -73,6 +183,14 @@ int FS::FileSeek(lfs_file_t* file_p, uint32_t pos) {
   return lfs_file_seek(&lfs, file_p, pos, LFS_SEEK_SET);
 }
 
+int FS::FileSync(lfs_file_t* file_p) {
+  return lfs_file_sync(&lfs, file_p);
+}
+
+lfs_soff_t FS::FileSize(lfs_file_t* file_p) {
+  return lfs_file_size(&lfs, file_p);
+}
+
 int FS::FileDelete(const char* fileName) {
   return lfs_remove(&lfs, fileName);
 }
@@ -105,10 +223,228 @@ int FS::Stat(const char* path, lfs_info* info) {
   return lfs_stat(&lfs, path, info);
 }
 
+lfs_ssize_t FS::GetAttribute(const char* path, uint8_t type, void* buffer, uint32_t size) {
+  return lfs_getattr(&lfs, path, type, buffer, size);
+}
+
+int FS::SetAttribute(const char* path, uint8_t type, const void* buffer, uint32_t size) {
+  return lfs_setattr(&lfs, path, type, buffer, size);
+}
+
+int FS::InstallAssets() {
+  lfs_file_t file;
+  int res = FileOpen(&file, assetImagePath, LFS_O_RDONLY);
+  if (res < 0) {
+    return res;
+  }
+
+  AssetPartition::Header header;
+  res = FileRead(&file, reinterpret_cast<uint8_t*>(&header), sizeof(header));
+  if (res != sizeof(header) || !assets.IsCompatible(header) || FileSize(&file) != static_cast<lfs_soff_t>(header.imageSize)) {
+    res = LFS_ERR_CORRUPT;
+  } else if (legacyLayout) {
+    // No asset partition : the A: drive reads the assets from the individual files
+    res = ExtractAssets(file, header);
+  } else {
+    NRF_LOG_INFO("[FS] Installing %d bytes of assets", header.imageSize);
+    TickType_t startTicks = xTaskGetTickCount();
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    assets.Disable();
+    xSemaphoreGive(mutex);
+
+    assets.Erase(header);
+    uint8_t buffer[64];
+    uint32_t offset = sizeof(header);
+    res = FileSeek(&file, offset);
+    while (res >= 0 && offset < header.imageSize) {
+      res = FileRead(&file, buffer, std::min<uint32_t>(sizeof(buffer), header.imageSize - offset));
+      if (res > 0) {
+        assets.Write(offset, buffer, res);
+        offset += res;
+      } else if (res == 0) {
+        res = LFS_ERR_CORRUPT;
+      }
+    }
+    if (res >= 0 && !assets.Commit(header)) {
+      res = LFS_ERR_CORRUPT;
+    }
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    readCache.Invalidate(assetsAddress, assetsSize);
+    bool loaded = assets.Load();
+    xSemaphoreGive(mutex);
+    if (res >= 0 && loaded) {
+      DeleteAssetFiles();
+    }
+    NRF_LOG_INFO("[FS] Assets installed in %d ms : %d", (xTaskGetTickCount() - startTicks) * 1000 / configTICK_RATE_HZ, res);
+  }
+  FileClose(&file);
+
+  // The image is not kept in the filesystem, there would be two copies of every asset
+  FileDelete(assetImagePath);
+  return (res < 0) ? res : 0;
+}
+
+// Copies each asset of the image to the file of the same path
+int FS::ExtractAssets(lfs_file_t& image, const AssetPartition::Header& header) {
+  NRF_LOG_INFO("[FS] Extracting the assets to files");
+  int res = 0;
+  for (uint16_t i = 0; i < header.nbBuckets && res >= 0; i++) {
+    AssetPartition::Bucket bucket;
+    res = FileSeek(&image, sizeof(AssetPartition::Header) + i * sizeof(AssetPartition::Bucket));
+    if (res >= 0) {
+      res = FileRead(&image, reinterpret_cast<uint8_t*>(&bucket), sizeof(bucket));
+    }
+    if (res >= 0 && (res != sizeof(bucket) || !assets.IsValid(bucket, header.imageSize))) {
+      res = LFS_ERR_CORRUPT;
+    }
+    if (res < 0 || bucket.hash == 0) {
+      continue;
+    }
+
+    char path[AssetPartition::maxNameLength + 1];
+    res = FileSeek(&image, bucket.nameOffset);
+    if (res >= 0 && FileRead(&image, reinterpret_cast<uint8_t*>(path), bucket.nameLength) != bucket.nameLength) {
+      res = LFS_ERR_CORRUPT;
+    }
+    if (res < 0) {
+      continue;
+    }
+    path[bucket.nameLength] = '\0';
+    // The directories of the package may not exist yet
+    for (char* separator = std::strchr(path + 1, '/'); separator != nullptr; separator = std::strchr(separator + 1, '/')) {
+      *separator = '\0';
+      DirCreate(path);
+      *separator = '/';
+    }
+
+    lfs_file_t output;
+    res = FileOpen(&output, path, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC);
+    if (res < 0) {
+      continue;
+    }
+    res = FileSeek(&image, bucket.offset);
+    uint8_t buffer[64];
+    for (uint32_t copied = 0; res >= 0 && copied < bucket.size; copied += res) {
+      res = FileRead(&image, buffer, std::min<uint32_t>(sizeof(buffer), bucket.size - copied));
+      if (res > 0) {
+        res = FileWrite(&output, buffer, res);
+      } else if (res == 0) {
+        res = LFS_ERR_CORRUPT;
+      }
+    }
+    int closeRes = FileClose(&output);
+    if (res >= 0) {
+      res = closeRes;
+    }
+  }
+  return res;
+}
+
+// Packages used to upload each asset as a file, the partition now replaces them
+void FS::DeleteAssetFiles() {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  const uint16_t nbBuckets = assets.NbBuckets();
+  xSemaphoreGive(mutex);
+  for (uint16_t i = 0; i < nbBuckets; i++) {
+    char path[AssetPartition::maxNameLength + 1];
+    // The mutex is also the lock of littlefs, it can't be held while the file is deleted
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    const bool found = assets.Name(i, path);
+    xSemaphoreGive(mutex);
+    if (found && FileDelete(path) == LFS_ERR_OK) {
+      NRF_LOG_INFO("[FS] %s replaced by the asset partition", path);
+    }
+  }
+}
+
+bool FS::AssetOpen(const char* path, AssetPartition::Asset& asset) {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  bool found = assets.Find(path, asset);
+  xSemaphoreGive(mutex);
+  return found;
+}
+
+bool FS::AssetExists(const char* path) {
+  const uint32_t hash = AssetPartition::Hash(path);
+  xSemaphoreTake(resourceMutex, portMAX_DELAY);
+  for (uint8_t i = 0; i < nbResources; i++) {
+    if (resources[i].hash == hash) {
+      bool available = resources[i].available;
+      xSemaphoreGive(resourceMutex);
+      return available;
+    }
+  }
+  xSemaphoreGive(resourceMutex);
+
+  // Not part of the package, or installed by a package without manifest
+  AssetPartition::Asset asset;
+  lfs_info info;
+  return AssetOpen(path, asset) || Stat(path, &info) == LFS_ERR_OK;
+}
+
+uint32_t FS::AssetRead(const AssetPartition::Asset& asset, uint32_t offset, void* buffer, uint32_t size) {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  uint32_t count = assets.Read(asset, offset, static_cast<uint8_t*>(buffer), size);
+  xSemaphoreGive(mutex);
+  return count;
+}
+
 lfs_ssize_t FS::GetFSSize() {
   return lfs_fs_size(&lfs);
 }
 
+int FS::Maintenance() {
+  TickType_t startTicks = xTaskGetTickCount();
+  int res = LFS_ERR_OK;
+  static_assert(LFS_VERSION >= 0x00020008, "lfs_fs_gc() requires littlefs 2.8 or later");
+  // Fills the lookahead buffer of the block allocator and, since littlefs 2.9, compacts the metadata pairs that are
+  // almost full. Free blocks can't be erased in advance : littlefs erases a block right before it is used.
+  res = lfs_fs_gc(&lfs);
+
+  std::array<uint8_t, (legacySize / blockSize + 7) / 8> used {};
+  if (res >= 0) {
+    res = lfs_fs_traverse(
+      &lfs,
+      [](void* data, lfs_block_t block) {
+        static_cast<uint8_t*>(data)[block / 8] |= 1 << (block % 8);
+        return 0;
+      },
+      used.data());
+  }
+  if (res >= 0) {
+    uint32_t blocksUsed = 0;
+    uint16_t freeExtents = 0;
+    uint16_t largestFreeExtent = 0;
+    uint16_t freeRun = 0;
+    for (lfs_block_t block = 0; block < lfsConfig.block_count; block++) {
+      if (used[block / 8] & (1 << (block % 8))) {
+        blocksUsed++;
+        freeRun = 0;
+        continue;
+      }
+      if (freeRun == 0) {
+        freeExtents++;
+      }
+      freeRun++;
+      largestFreeExtent = std::max(largestFreeExtent, freeRun);
+    }
+    stats.blocksUsed = blocksUsed;
+    stats.freeExtents = freeExtents;
+    stats.largestFreeExtent = largestFreeExtent;
+  }
+
+  stats.maintenanceRuns++;
+  stats.maintenanceTime = (xTaskGetTickCount() - startTicks) * 1000 / configTICK_RATE_HZ;
+  NRF_LOG_INFO("[FS] Maintenance in %d ms : %d, %d blocks used, %d free extents",
+               stats.maintenanceTime,
+               res,
+               stats.blocksUsed,
+               stats.freeExtents);
+  return (res < 0) ? res : 0;
+}
+
 /*
 
     ----------- Interface between littlefs and SpiNorFlash -----------
@@ -118,9 +454,26 @@ int FS::SectorSync(const struct lfs_config* /*c*/) {
   return 0;
 }
 
+int FS::Lock(const struct lfs_config* c) {
+  Pinetime::Controllers::FS& lfs = *(static_cast<Pinetime::Controllers::FS*>(c->context));
+  xSemaphoreTake(lfs.mutex, portMAX_DELAY);
+  lfs.lockTicks = xTaskGetTickCount();
+  return 0;
+}
+
+int FS::Unlock(const struct lfs_config* c) {
+  Pinetime::Controllers::FS& lfs = *(static_cast<Pinetime::Controllers::FS*>(c->context));
+  const uint32_t lockTime = (xTaskGetTickCount() - lfs.lockTicks) * 1000 / configTICK_RATE_HZ;
+  lfs.stats.maxLockTime = std::max(lfs.stats.maxLockTime, lockTime);
+  xSemaphoreGive(lfs.mutex);
+  return 0;
+}
+
 int FS::SectorErase(const struct lfs_config* c, lfs_block_t block) {
   Pinetime::Controllers::FS& lfs = *(static_cast<Pinetime::Controllers::FS*>(c->context));
   const size_t address = startAddress + (block * blockSize);
+  lfs.readCache.Invalidate(address, blockSize);
+  lfs.stats.erases++;
   lfs.flashDriver.SectorErase(address);
   return lfs.flashDriver.EraseFailed() ? -1 : 0;
 }
@@ -128,6 +481,8 @@ int FS::SectorErase(const struct lfs_config* c, lfs_block_t block) {
 int FS::SectorProg(const struct lfs_config* c, lfs_block_t block, lfs_off_t off, const void* buffer, lfs_size_t size) {
   Pinetime::Controllers::FS& lfs = *(static_cast<Pinetime::Controllers::FS*>(c->context));
   const size_t address = startAddress + (block * blockSize) + off;
+  lfs.readCache.Invalidate(address, size);
+  lfs.stats.programs++;
   lfs.flashDriver.Write(address, (uint8_t*) buffer, size);
   return lfs.flashDriver.ProgramFailed() ? -1 : 0;
 }
@@ -135,6 +490,6 @@ int FS::SectorProg(const struct lfs_config* c, lfs_block_t block, lfs_off_t off,
 int FS::SectorRead(const struct lfs_config* c, lfs_block_t block, lfs_off_t off, void* buffer, lfs_size_t size) {
   Pinetime::Controllers::FS& lfs = *(static_cast<Pinetime::Controllers::FS*>(c->context));
   const size_t address = startAddress + (block * blockSize) + off;
-  lfs.flashDriver.Read(address, static_cast<uint8_t*>(buffer), size);
+  lfs.readCache.Read(address, static_cast<uint8_t*>(buffer), size);
   return 0;
 }
@@ -1,8 +1,13 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include "drivers/SpiNorFlash.h"
+#include "components/fs/FlashReadCache.h"
+#include "components/fs/AssetPartition.h"
 #include <littlefs/lfs.h>
+#include <FreeRTOS.h>
+#include <semphr.h>
 
 namespace Pinetime {
   namespace Controllers {
@@ -17,6 +22,8 @@ namespace Pinetime {
       int FileRead(lfs_file_t* file_p, uint8_t* buff, uint32_t size);
       int FileWrite(lfs_file_t* file_p, const uint8_t* buff, uint32_t size);
       int FileSeek(lfs_file_t* file_p, uint32_t pos);
+      int FileSync(lfs_file_t* file_p);
+      lfs_soff_t FileSize(lfs_file_t* file_p);
 
       int FileDelete(const char* fileName);
 
@@ -29,18 +36,70 @@ namespace Pinetime {
       lfs_ssize_t GetFSSize();
       int Rename(const char* oldPath, const char* newPath);
       int Stat(const char* path, lfs_info* info);
+      lfs_ssize_t GetAttribute(const char* path, uint8_t type, void* buffer, uint32_t size);
+      int SetAttribute(const char* path, uint8_t type, const void* buffer, uint32_t size);
+
+      // List of the resources of the package (path, size and CRC32), written by generate-package.py
+      static constexpr const char* resourceManifestPath = "/resources.idx";
+      // Loads the manifest and checks that each resource is installed with the expected size. Must be called again
+      // when files are added or removed.
       void VerifyResource();
 
-      static size_t getSize() {
-        return size;
+      // Asset image received from the companion app, installed in the asset partition by InstallAssets(). Filesystems
+      // that still cover the asset partition get the assets of the image as individual files instead.
+      static constexpr const char* assetImagePath = "/assets.bin";
+      int InstallAssets();
+      bool AssetOpen(const char* path, AssetPartition::Asset& asset);
+      // True if the asset is in the asset partition or in the filesystem. Answered from RAM for the resources of
+      // the manifest, so that the availability of the apps and watch faces can be checked without reading the flash.
+      bool AssetExists(const char* path);
+      uint32_t AssetRead(const AssetPartition::Asset& asset, uint32_t offset, void* buffer, uint32_t size);
+
+      // False if the filesystem was formatted before the asset partition existed and still covers it
+      bool HasAssetPartition() const {
+        return !legacyLayout;
+      }
+
+      size_t getSize() const {
+        return lfsConfig.block_count * blockSize;
       }
 
       static size_t getBlockSize() {
         return blockSize;
       }
 
+      const FlashReadCache::Stats& ReadCacheStats() const {
+        return readCache.GetStats();
+      }
+
+      struct UsageStats {
+        uint32_t blocksUsed = 0;
+        // Number of runs of free blocks and length of the longest one : the higher the number of runs, the more the
+        // free space is fragmented
+        uint16_t freeExtents = 0;
+        uint16_t largestFreeExtent = 0;
+        // Block erases and page programs since boot
+        uint32_t erases = 0;
+        uint32_t programs = 0;
+        // Longest time a littlefs call held the filesystem since boot, in ms
+        uint32_t maxLockTime = 0;
+        uint32_t maintenanceRuns = 0;
+        // Duration of the last maintenance, in ms
+        uint32_t maintenanceTime = 0;
+      };
+
+      // Does the garbage collection littlefs would otherwise do on the path of the next writes, and updates the
+      // block usage of the stats. Runs in the storage task, when the watch is idle on its charger.
+      int Maintenance();
+
+      const UsageStats& GetUsageStats() const {
+        return stats;
+      }
+
     private:
       Pinetime::Drivers::SpiNorFlash& flashDriver;
+      FlashReadCache readCache;
+      AssetPartition assets;
 
       /*
        * External Flash MAP (4 MBytes)
@@ -61,19 +120,70 @@ namespace Pinetime {
        *          |                                       |
        *          |                                       |
        *          |                                       |
+       * 0x3C0000 +---------------------------------------+
+       *          |  Assets                               |
+       *          |  256 KBytes                           |
        * 0x400000 +---------------------------------------+
        *
+       * Filesystems formatted before the asset partition was added span up to 0x400000 (legacyLayout).
        */
       static constexpr size_t startAddress = 0x0B4000;
-      static constexpr size_t size = 0x34C000;
+      static constexpr size_t size = 0x30C000;
+      static constexpr size_t legacySize = 0x34C000;
       static constexpr size_t blockSize = 4096;
+      static constexpr size_t assetsAddress = startAddress + size;
+      static constexpr size_t assetsSize = 0x40000;
+
+      // Attribute of the root directory, set when the filesystem is formatted next to the asset partition
+      static constexpr uint8_t layoutAttribute = 1;
+      static constexpr uint8_t assetsLayout = 1;
+
+      int Mount();
+      bool ResourceInstalled(const char* path, uint32_t size);
+      int ExtractAssets(lfs_file_t& image, const AssetPartition::Header& header);
+      void DeleteAssetFiles();
+
+      struct ManifestHeader {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t nbResources;
+      };
+
+      // Followed by pathLength characters, without null terminator
+      struct __attribute__((packed)) ManifestEntry {
+        uint32_t size;
+        uint32_t crc;
+        uint8_t pathLength;
+      };
+
+      struct Resource {
+        // AssetPartition::Hash() of the path
+        uint32_t hash;
+        bool available;
+      };
+
+      static constexpr uint32_t manifestMagic = 0x49525450; // "PTRI"
+      static constexpr uint16_t manifestVersion = 1;
+      static constexpr uint8_t maxResources = 32;
+      static constexpr uint8_t maxResourcePathLength = 64;
 
+      // Protects the resource index, which is rebuilt by SystemTask and read by DisplayApp
+      SemaphoreHandle_t resourceMutex;
+      std::array<Resource, maxResources> resources;
+      uint8_t nbResources = 0;
       bool resourcesValid = false;
-      const struct lfs_config lfsConfig;
+      bool legacyLayout = false;
+      // Taken by littlefs around each of its calls (LFS_THREADSAFE), so the filesystem can be used from any task
+      SemaphoreHandle_t mutex;
+      TickType_t lockTicks = 0;
+      UsageStats stats;
+      struct lfs_config lfsConfig;
 
       lfs_t lfs;
 
       static int SectorSync(const struct lfs_config* c);
+      static int Lock(const struct lfs_config* c);
+      static int Unlock(const struct lfs_config* c);
       static int SectorErase(const struct lfs_config* c, lfs_block_t block);
       static int SectorProg(const struct lfs_config* c, lfs_block_t block, lfs_off_t off, const void* buffer, lfs_size_t size);
       static int SectorRead(const struct lfs_config* c, lfs_block_t block, lfs_off_t off, void* buffer, lfs_size_t size);
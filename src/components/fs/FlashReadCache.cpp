@@ -0,0 +1,110 @@
+#include "components/fs/FlashReadCache.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace Pinetime::Controllers;
+
+static_assert(PINETIME_FS_READ_CACHE_PAGES >= 1, "The read cache needs at least one page");
+
+FlashReadCache::FlashReadCache(Pinetime::Drivers::SpiNorFlash& flashDriver) : flashDriver {flashDriver} {
+}
+
+void FlashReadCache::Read(uint32_t address, uint8_t* buffer, size_t size) {
+  if (size >= pageSize) {
+    stats.bypassed++;
+    stats.flashReads++;
+    flashDriver.Read(address, buffer, size);
+    return;
+  }
+
+  while (size > 0) {
+    const uint32_t pageAddress = address & ~static_cast<uint32_t>(pageSize - 1);
+    const size_t offset = address - pageAddress;
+    const size_t count = std::min(size, pageSize - offset);
+
+    size_t index;
+    int found = Find(pageAddress);
+    if (found < 0) {
+      stats.misses++;
+      index = Load(pageAddress);
+    } else {
+      stats.hits++;
+      index = static_cast<size_t>(found);
+    }
+    pages[index].lastUse = ++useCounter;
+    std::memcpy(buffer, &data[index * pageSize + offset], count);
+
+    address += count;
+    buffer += count;
+    size -= count;
+  }
+}
+
+void FlashReadCache::Invalidate(uint32_t address, size_t size) {
+  const uint32_t end = address + size;
+  for (auto& page : pages) {
+    if (page.address != invalidAddress && page.address < end && page.address + pageSize > address) {
+      page.address = invalidAddress;
+    }
+  }
+  lastMiss = invalidAddress;
+}
+
+int FlashReadCache::Find(uint32_t address) const {
+  for (size_t i = 0; i < nbPages; i++) {
+    if (pages[i].address == address) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+size_t FlashReadCache::LeastRecentlyUsed() const {
+  size_t victim = 0;
+  for (size_t i = 0; i < nbPages; i++) {
+    if (pages[i].address == invalidAddress) {
+      return i;
+    }
+    if (pages[i].lastUse < pages[victim].lastUse) {
+      victim = i;
+    }
+  }
+  return victim;
+}
+
+size_t FlashReadCache::Load(uint32_t address) {
+  const bool sequential = (lastMiss != invalidAddress) && (address == lastMiss + pageSize);
+  lastMiss = address;
+
+  // Read ahead: littlefs walks the metadata blocks forward, so the next page will most likely be needed too.
+  // Both pages are loaded with a single read into two adjacent slots, the pair that was used the least recently.
+  // The read ahead stays within the sector, the next one is an unrelated littlefs block.
+  const bool lastPageOfSector = ((address + pageSize) % Pinetime::Drivers::SpiNorFlash::sectorSize) == 0;
+  if (nbPages >= 4 && sequential && !lastPageOfSector && Find(address + pageSize) < 0) {
+    size_t victim = 0;
+    uint32_t oldest = UINT32_MAX;
+    for (size_t i = 0; i + 1 < nbPages; i++) {
+      uint32_t lastUse = std::max(pages[i].lastUse, pages[i + 1].lastUse);
+      if (pages[i].address == invalidAddress && pages[i + 1].address == invalidAddress) {
+        lastUse = 0;
+      }
+      if (lastUse < oldest) {
+        oldest = lastUse;
+        victim = i;
+      }
+    }
+    stats.flashReads++;
+    flashDriver.Read(address, &data[victim * pageSize], 2 * pageSize);
+    pages[victim].address = address;
+    pages[victim + 1].address = address + pageSize;
+    pages[victim + 1].lastUse = ++useCounter;
+    lastMiss = address + pageSize;
+    return victim;
+  }
+
+  size_t victim = LeastRecentlyUsed();
+  stats.flashReads++;
+  flashDriver.Read(address, &data[victim * pageSize], pageSize);
+  pages[victim].address = address;
+  return victim;
+}
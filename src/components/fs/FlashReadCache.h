@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "drivers/SpiNorFlash.h"
+
+// Number of 256 bytes pages kept in RAM to serve the small reads of littlefs, can be overridden at build time
+#ifndef PINETIME_FS_READ_CACHE_PAGES
+  #define PINETIME_FS_READ_CACHE_PAGES 4
+#endif
+
+namespace Pinetime {
+  namespace Controllers {
+    /** LRU cache of SPI flash pages between littlefs and the flash driver.
+     * littlefs reads its metadata in chunks of read_size (16 bytes), each of them being a separate SPI transaction
+     * without this cache. On a miss the whole page is loaded, and when the misses are sequential the next page is
+     * loaded in the same transaction. Reads of at least a page bypass the cache: they are already efficient.
+     * Writes and erases go directly to the flash and invalidate the pages they touch. */
+    class FlashReadCache {
+    public:
+      struct Stats {
+        uint32_t hits;
+        uint32_t misses;
+        uint32_t bypassed;
+        // Number of read transactions sent to the flash
+        uint32_t flashReads;
+      };
+
+      explicit FlashReadCache(Pinetime::Drivers::SpiNorFlash& flashDriver);
+
+      void Read(uint32_t address, uint8_t* buffer, size_t size);
+      void Invalidate(uint32_t address, size_t size);
+
+      const Stats& GetStats() const {
+        return stats;
+      }
+
+    private:
+      static constexpr size_t pageSize = Pinetime::Drivers::SpiNorFlash::pageSize;
+      static constexpr size_t nbPages = PINETIME_FS_READ_CACHE_PAGES;
+      static constexpr uint32_t invalidAddress = 0xFFFFFFFF;
+
+      struct Page {
+        uint32_t address = invalidAddress;
+        uint32_t lastUse = 0;
+      };
+
+      int Find(uint32_t address) const;
+      size_t Load(uint32_t address);
+      size_t LeastRecentlyUsed() const;
+
+      Pinetime::Drivers::SpiNorFlash& flashDriver;
+      std::array<Page, nbPages> pages;
+      alignas(4) std::array<uint8_t, nbPages * pageSize> data;
+      uint32_t useCounter = 0;
+      uint32_t lastMiss = invalidAddress;
+      Stats stats {};
+    };
+  }
+}
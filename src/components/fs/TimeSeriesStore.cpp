@@ -0,0 +1,250 @@
+#include "components/fs/TimeSeriesStore.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <littlefs/lfs.h>
+#include "nrf_assert.h"
+
+using namespace Pinetime::Controllers;
+
+TimeSeriesStore::TimeSeriesStore(System::StorageTask& storage,
+                                 const char* directory,
+                                 uint8_t valueSize,
+                                 uint16_t recordsPerSegment,
+                                 uint8_t nbSegments,
+                                 uint8_t batchSize)
+  : storage {storage},
+    directory {directory},
+    valueSize {valueSize},
+    recordSize {static_cast<uint8_t>(sizeof(uint32_t) + valueSize)},
+    recordsPerSegment {recordsPerSegment},
+    nbSegments {nbSegments},
+    batchSize {batchSize} {
+  ASSERT(valueSize <= maxValueSize);
+  ASSERT(nbSegments >= 2 && nbSegments <= maxSegments);
+  ASSERT(batchSize >= 1 && batchSize <= maxBatchSize);
+  ASSERT(recordsPerSegment > 0);
+
+  for (uint8_t i = 0; i < nbSegments; i++) {
+    snprintf(paths[i].data(), maxPathSize, "%s/%u", directory, i);
+  }
+
+  mutex = xSemaphoreCreateMutex();
+  ASSERT(mutex != nullptr);
+}
+
+void TimeSeriesStore::Init() {
+  storage.CreateDir(directory);
+
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  bool found = false;
+  for (uint8_t i = 0; i < nbSegments; i++) {
+    segments[i] = {};
+    lfs_info info;
+    if (storage.StatBlocking(paths[i].data(), &info) < 0 || info.type != LFS_TYPE_REG) {
+      continue;
+    }
+    uint32_t startTime;
+    if (info.size < recordSize || storage.ReadBlocking(paths[i].data(), 0, &startTime, sizeof(startTime)) != sizeof(startTime)) {
+      continue;
+    }
+    // A partial record at the end of the file (power loss during a write) is ignored. The segment is closed so that
+    // the next records are not appended after it.
+    segments[i].startTime = startTime;
+    segments[i].count = std::min<uint32_t>(info.size / recordSize, recordsPerSegment);
+    segments[i].closed = (info.size % recordSize) != 0;
+    if (!found || startTime >= segments[current].startTime) {
+      current = i;
+      found = true;
+    }
+  }
+  batchCount = 0;
+  xSemaphoreGive(mutex);
+}
+
+void TimeSeriesStore::Append(uint32_t timestamp, const void* value) {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  if (segments[current].count >= recordsPerSegment || segments[current].closed) {
+    FlushLocked();
+    Rotate(timestamp);
+  }
+  if (segments[current].count == 0) {
+    segments[current].startTime = timestamp;
+  }
+
+  uint8_t* record = batch.data() + batchCount * recordSize;
+  std::memcpy(record, &timestamp, sizeof(timestamp));
+  std::memcpy(record + sizeof(timestamp), value, valueSize);
+  batchCount++;
+  segments[current].count++;
+
+  if (batchCount >= batchSize) {
+    FlushLocked();
+  }
+  xSemaphoreGive(mutex);
+}
+
+void TimeSeriesStore::Flush() {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  FlushLocked();
+  xSemaphoreGive(mutex);
+}
+
+void TimeSeriesStore::FlushLocked() {
+  // The storage task writes the consecutive appends to the same file with a single open/close
+  for (uint8_t i = 0; i < batchCount; i++) {
+    if (!storage.Append(paths[current].data(), batch.data() + i * recordSize, recordSize)) {
+      // The records that could not be queued are lost
+      segments[current].count -= batchCount - i;
+      break;
+    }
+  }
+  batchCount = 0;
+}
+
+void TimeSeriesStore::Rotate(uint32_t timestamp) {
+  current = (current + 1) % nbSegments;
+  if (segments[current].count > 0) {
+    storage.Delete(paths[current].data());
+  }
+  segments[current] = {timestamp, 0, false};
+}
+
+void TimeSeriesStore::Clear() {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  batchCount = 0;
+  for (uint8_t i = 0; i < nbSegments; i++) {
+    if (segments[i].count > 0) {
+      storage.Delete(paths[i].data());
+    }
+    segments[i] = {};
+  }
+  current = 0;
+  xSemaphoreGive(mutex);
+}
+
+uint32_t TimeSeriesStore::Count() const {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  uint32_t count = 0;
+  for (uint8_t i = 0; i < nbSegments; i++) {
+    count += segments[i].count;
+  }
+  xSemaphoreGive(mutex);
+  return count;
+}
+
+uint8_t TimeSeriesStore::OrderedSlots(std::array<uint8_t, maxSegments>& slots) const {
+  // Segments are started one after the other, the oldest one follows the current one
+  uint8_t nbSlots = 0;
+  for (uint8_t i = 1; i <= nbSegments; i++) {
+    uint8_t slot = (current + i) % nbSegments;
+    if (segments[slot].count > 0) {
+      slots[nbSlots++] = slot;
+    }
+  }
+  return nbSlots;
+}
+
+uint16_t TimeSeriesStore::FlushedCount(uint8_t slot) const {
+  return (slot == current) ? segments[slot].count - batchCount : segments[slot].count;
+}
+
+uint16_t TimeSeriesStore::ReadRecords(uint8_t slot, uint16_t index, uint16_t count, uint8_t* buffer) const {
+  // The records of the current segment that are still in RAM follow the ones that are in the file
+  uint16_t flushed = FlushedCount(slot);
+  uint16_t nbRead = 0;
+  if (index < flushed) {
+    uint16_t fromFile = std::min<uint16_t>(count, flushed - index);
+    int res = storage.ReadBlocking(paths[slot].data(), index * recordSize, buffer, fromFile * recordSize);
+    if (res < static_cast<int>(fromFile * recordSize)) {
+      return (res > 0) ? res / recordSize : 0;
+    }
+    nbRead = fromFile;
+    index += fromFile;
+  }
+  if (nbRead < count) {
+    uint16_t fromBatch = count - nbRead;
+    std::memcpy(buffer + nbRead * recordSize, batch.data() + (index - flushed) * recordSize, fromBatch * recordSize);
+    nbRead += fromBatch;
+  }
+  return nbRead;
+}
+
+uint32_t TimeSeriesStore::Timestamp(const uint8_t* record) const {
+  uint32_t timestamp;
+  std::memcpy(&timestamp, record, sizeof(timestamp));
+  return timestamp;
+}
+
+uint16_t TimeSeriesStore::ReadLast(void* buffer, uint16_t maxCount) const {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  std::array<uint8_t, maxSegments> slots;
+  uint8_t nbSlots = OrderedSlots(slots);
+
+  uint32_t total = 0;
+  for (uint8_t i = 0; i < nbSlots; i++) {
+    total += segments[slots[i]].count;
+  }
+  uint32_t skip = total - std::min<uint32_t>(total, maxCount);
+
+  auto* output = static_cast<uint8_t*>(buffer);
+  uint16_t nbRead = 0;
+  for (uint8_t i = 0; i < nbSlots && nbRead < maxCount; i++) {
+    uint16_t count = segments[slots[i]].count;
+    if (skip >= count) {
+      skip -= count;
+      continue;
+    }
+    uint16_t toRead = std::min<uint16_t>(count - skip, maxCount - nbRead);
+    uint16_t res = ReadRecords(slots[i], skip, toRead, output + nbRead * recordSize);
+    nbRead += res;
+    skip = 0;
+    if (res < toRead) {
+      break;
+    }
+  }
+  xSemaphoreGive(mutex);
+  return nbRead;
+}
+
+uint16_t TimeSeriesStore::ReadRange(uint32_t from, uint32_t to, void* buffer, uint16_t maxCount) const {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  std::array<uint8_t, maxSegments> slots;
+  uint8_t nbSlots = OrderedSlots(slots);
+
+  auto* output = static_cast<uint8_t*>(buffer);
+  uint16_t nbRead = 0;
+  for (uint8_t i = 0; i < nbSlots && nbRead < maxCount; i++) {
+    const Segment& segment = segments[slots[i]];
+    if (segment.startTime >= to) {
+      break;
+    }
+    // All the records of this segment are older than the start of the next one
+    if (i + 1 < nbSlots && segments[slots[i + 1]].startTime <= from) {
+      continue;
+    }
+
+    // The records are read into the free part of the output buffer, the ones out of the range are then
+    // overwritten by the next ones
+    uint16_t index = 0;
+    while (index < segment.count && nbRead < maxCount) {
+      uint16_t toRead = std::min<uint16_t>(segment.count - index, maxCount - nbRead);
+      uint16_t chunkStart = nbRead;
+      uint16_t res = ReadRecords(slots[i], index, toRead, output + chunkStart * recordSize);
+      for (uint16_t r = 0; r < res; r++) {
+        uint8_t* record = output + (chunkStart + r) * recordSize;
+        uint32_t timestamp = Timestamp(record);
+        if (timestamp >= from && timestamp < to) {
+          std::memmove(output + nbRead * recordSize, record, recordSize);
+          nbRead++;
+        }
+      }
+      if (res < toRead) {
+        break;
+      }
+      index += res;
+    }
+  }
+  xSemaphoreGive(mutex);
+  return nbRead;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <FreeRTOS.h>
+#include <semphr.h>
+#include "storagetask/StorageTask.h"
+
+namespace Pinetime {
+  namespace Controllers {
+    /** Log of timestamped fixed size values (heart rate, battery level...) stored in the filesystem.
+     *
+     * The records are appended to segment files (<directory>/0, <directory>/1...) that are never modified once
+     * written. When the current segment is full, the next one is started, and the oldest segment is deleted once
+     * all of them are used: nothing is overwritten in place.
+     * Records are kept in RAM and written by batches through the storage task. The start time of each segment is
+     * kept in RAM too, so queries only read the segments that overlap the requested range.
+     *
+     * Records are packed : a 32 bits timestamp followed by valueSize bytes of value. */
+    class TimeSeriesStore {
+    public:
+      static constexpr size_t maxValueSize = System::StorageTask::maxDataSize - sizeof(uint32_t);
+      static constexpr uint8_t maxSegments = 8;
+      static constexpr uint8_t maxBatchSize = 8;
+
+      TimeSeriesStore(System::StorageTask& storage,
+                      const char* directory,
+                      uint8_t valueSize,
+                      uint16_t recordsPerSegment,
+                      uint8_t nbSegments,
+                      uint8_t batchSize);
+
+      // Must be called once the storage task is started
+      void Init();
+
+      void Append(uint32_t timestamp, const void* value);
+      // Writes the records that are still in RAM
+      void Flush();
+      void Clear();
+
+      uint32_t Count() const;
+      size_t RecordSize() const {
+        return recordSize;
+      }
+
+      // Copies the last maxCount records (oldest first) in buffer, which must hold maxCount * RecordSize() bytes
+      uint16_t ReadLast(void* buffer, uint16_t maxCount) const;
+      // Copies the records with from <= timestamp < to (oldest first), up to maxCount
+      uint16_t ReadRange(uint32_t from, uint32_t to, void* buffer, uint16_t maxCount) const;
+
+    private:
+      static constexpr size_t maxPathSize = 24;
+
+      struct Segment {
+        uint32_t startTime = 0;
+        // Number of records, including the ones of the batch for the current segment
+        uint16_t count = 0;
+        // No record can be appended anymore
+        bool closed = false;
+      };
+
+      void Rotate(uint32_t timestamp);
+      void FlushLocked();
+      uint16_t FlushedCount(uint8_t slot) const;
+      uint16_t ReadRecords(uint8_t slot, uint16_t index, uint16_t count, uint8_t* buffer) const;
+      uint32_t Timestamp(const uint8_t* record) const;
+      // Segment slots that contain records, oldest first
+      uint8_t OrderedSlots(std::array<uint8_t, maxSegments>& slots) const;
+
+      System::StorageTask& storage;
+      const char* directory;
+      const uint8_t valueSize;
+      const uint8_t recordSize;
+      const uint16_t recordsPerSegment;
+      const uint8_t nbSegments;
+      const uint8_t batchSize;
+
+      std::array<std::array<char, maxPathSize>, maxSegments> paths;
+      std::array<Segment, maxSegments> segments;
+      uint8_t current = 0;
+
+      std::array<uint8_t, maxBatchSize * System::StorageTask::maxDataSize> batch;
+      uint8_t batchCount = 0;
+
+      mutable SemaphoreHandle_t mutex;
+    };
+  }
+}
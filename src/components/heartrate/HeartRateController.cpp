@@ -6,10 +6,15 @@
 using namespace Pinetime::Controllers;
 
 void HeartRateController::Update(HeartRateController::States newState, uint8_t heartRate) {
+  bool changed = this->state != newState;
   this->state = newState;
   if (this->heartRate != heartRate) {
     this->heartRate = heartRate;
     service->OnNewHeartRateValue(heartRate);
+    changed = true;
+  }
+  if (changed) {
+    changeNotifier.Notify();
   }
   if (newState == States::Running && heartRate > 0 && logger != nullptr) {
     logger->AddMeasurement(heartRate);
@@ -19,6 +24,7 @@ void HeartRateController::Update(HeartRateController::States newState, uint8_t h
 void HeartRateController::Enable() {
   if (task != nullptr) {
     state = States::NotEnoughData;
+    changeNotifier.Notify();
     task->PushMessage(Pinetime::Applications::HeartRateTask::Messages::Enable);
   }
 }
@@ -26,6 +32,7 @@ void HeartRateController::Enable() {
 void HeartRateController::Disable() {
   if (task != nullptr) {
     state = States::Stopped;
+    changeNotifier.Notify();
     task->PushMessage(Pinetime::Applications::HeartRateTask::Messages::Disable);
   }
 }
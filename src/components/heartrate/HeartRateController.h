@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <components/ble/HeartRateService.h>
+#include "utility/DataChangeNotifier.h"
 
 namespace Pinetime {
   namespace Applications {
@@ -37,12 +38,17 @@ namespace Pinetime {
       void SetService(Pinetime::Controllers::HeartRateService* service);
       void SetLogger(Pinetime::Controllers::HeartRateLogger* logger);
 
+      void Subscribe(Utility::DataChangeListener* listener) {
+        changeNotifier.Subscribe(listener);
+      }
+
     private:
       Applications::HeartRateTask* task = nullptr;
       States state = States::Stopped;
       uint8_t heartRate = 0;
       Pinetime::Controllers::HeartRateService* service = nullptr;
       Pinetime::Controllers::HeartRateLogger* logger = nullptr;
+      Utility::DataChangeNotifier changeNotifier {Utility::DataSource::HeartRate};
     };
   }
 }
\ No newline at end of file
@@ -1,38 +1,52 @@
 #include "components/heartrate/HeartRateLogger.h"
-#include "components/fs/FS.h"
 #include "components/datetime/DateTimeController.h"
+#include "storagetask/StorageTask.h"
 
+#include <algorithm>
 #include <cstring>
 
 using namespace Pinetime::Controllers;
 
-HeartRateLogger::HeartRateLogger(Controllers::FS& fs, Controllers::DateTime& dateTime) : fs {fs}, dateTime {dateTime} {
+HeartRateLogger::HeartRateLogger(System::StorageTask& storage, Controllers::DateTime& dateTime)
+  : storage {storage}, dateTime {dateTime}, store {storage, logPath, sizeof(Entry::bpm), entriesPerSegment, nbSegments, batchSize} {
 }
 
 void HeartRateLogger::Init() {
-  LoadHeader();
+  storage.CreateDir(dirPath);
+  store.Init();
+  ImportLegacyLog();
 }
 
-void HeartRateLogger::LoadHeader() {
-  lfs_file_t file;
-  if (fs.FileOpen(&file, filePath, LFS_O_RDONLY) == LFS_ERR_OK) {
-    FileHeader readHeader;
-    if (fs.FileRead(&file, reinterpret_cast<uint8_t*>(&readHeader), sizeof(FileHeader)) == sizeof(FileHeader)) {
-      if (readHeader.version == 1 && readHeader.writeIndex < maxEntries && readHeader.count <= maxEntries) {
-        header = readHeader;
+// Appends the entries of the log file of the previous versions to the store, oldest first, then deletes the file
+void HeartRateLogger::ImportLegacyLog() {
+  LegacyHeader header;
+  if (storage.ReadBlocking(legacyFilePath, 0, &header, sizeof(header)) != sizeof(header)) {
+    return;
+  }
+  // The entries were already imported if the store is not empty : the file could not be deleted
+  if (header.version == 1 && header.writeIndex < legacyMaxEntries && header.count <= legacyMaxEntries && store.Count() == 0) {
+    uint16_t index = (header.count < legacyMaxEntries) ? 0 : header.writeIndex;
+    // The appends of a chunk fit in the queue of the storage task, the read of the next chunk waits for them
+    static constexpr uint16_t chunkSize = 2 * batchSize;
+    Entry entries[chunkSize];
+    for (uint16_t imported = 0; imported < header.count;) {
+      uint16_t count = std::min<uint16_t>(
+        {chunkSize, static_cast<uint16_t>(header.count - imported), static_cast<uint16_t>(legacyMaxEntries - index)});
+      int res = storage.ReadBlocking(legacyFilePath, sizeof(LegacyHeader) + index * sizeof(Entry), entries, count * sizeof(Entry));
+      if (res != static_cast<int>(count * sizeof(Entry))) {
+        break;
+      }
+      for (uint16_t i = 0; i < count; i++) {
+        if (entries[i].bpm != 0) {
+          store.Append(entries[i].timestamp, &entries[i].bpm);
+        }
       }
+      imported += count;
+      index = (index + count) % legacyMaxEntries;
     }
-    fs.FileClose(&file);
-  }
-}
-
-void HeartRateLogger::SaveHeader() {
-  lfs_file_t file;
-  fs.DirCreate(dirPath);
-  if (fs.FileOpen(&file, filePath, LFS_O_RDWR | LFS_O_CREAT) == LFS_ERR_OK) {
-    fs.FileWrite(&file, reinterpret_cast<const uint8_t*>(&header), sizeof(FileHeader));
-    fs.FileClose(&file);
+    store.Flush();
   }
+  storage.Delete(legacyFilePath);
 }
 
 void HeartRateLogger::AddMeasurement(uint8_t bpm) {
@@ -49,73 +63,44 @@ void HeartRateLogger::AddMeasurement(uint8_t bpm) {
   }
   lastLogTimestamp = nowSeconds;
 
-  Entry entry;
-  entry.timestamp = nowSeconds;
-  entry.bpm = bpm;
-
-  WriteEntry(entry);
-
-  header.writeIndex = (header.writeIndex + 1) % maxEntries;
-  if (header.count < maxEntries) {
-    header.count++;
-  }
-  SaveHeader();
+  store.Append(nowSeconds, &bpm);
 }
 
-void HeartRateLogger::WriteEntry(const Entry& entry) {
-  lfs_file_t file;
-  fs.DirCreate(dirPath);
-  if (fs.FileOpen(&file, filePath, LFS_O_RDWR | LFS_O_CREAT) == LFS_ERR_OK) {
-    lfs_off_t offset = sizeof(FileHeader) + (header.writeIndex * sizeof(Entry));
-    fs.FileSeek(&file, offset);
-    fs.FileWrite(&file, reinterpret_cast<const uint8_t*>(&entry), sizeof(Entry));
-    fs.FileClose(&file);
-  }
+void HeartRateLogger::Flush() {
+  store.Flush();
 }
 
 uint16_t HeartRateLogger::GetRecentEntries(Entry* buffer, uint16_t maxCount) const {
-  if (header.count == 0 || maxCount == 0) {
-    return 0;
-  }
-
-  uint16_t toRead = (maxCount < header.count) ? maxCount : header.count;
-
-  lfs_file_t file;
-  if (fs.FileOpen(const_cast<lfs_file_t*>(&file), filePath, LFS_O_RDONLY) != LFS_ERR_OK) {
-    return 0;
-  }
+  uint16_t count = store.ReadLast(buffer, maxCount);
+  Unpack(buffer, count);
+  return count;
+}
 
-  // Read entries in chronological order (oldest first)
-  // The oldest entry is at writeIndex (if buffer is full) or at 0 (if not full)
-  uint16_t startIndex;
-  if (header.count < maxEntries) {
-    // Buffer not full yet, oldest entry is at max(0, count - toRead)
-    startIndex = header.count - toRead;
-  } else {
-    // Buffer is full, oldest is at writeIndex
-    // We want the most recent toRead entries, so start at (writeIndex - toRead + maxEntries) % maxEntries
-    startIndex = (header.writeIndex + maxEntries - toRead) % maxEntries;
-  }
+uint16_t HeartRateLogger::GetEntries(uint32_t from, uint32_t to, Entry* buffer, uint16_t maxCount) const {
+  uint16_t count = store.ReadRange(from, to, buffer, maxCount);
+  Unpack(buffer, count);
+  return count;
+}
 
-  for (uint16_t i = 0; i < toRead; i++) {
-    uint16_t idx = (startIndex + i) % maxEntries;
-    lfs_off_t offset = sizeof(FileHeader) + (idx * sizeof(Entry));
-    const_cast<FS&>(fs).FileSeek(const_cast<lfs_file_t*>(&file), offset);
-    const_cast<FS&>(fs).FileRead(const_cast<lfs_file_t*>(&file), reinterpret_cast<uint8_t*>(&buffer[i]), sizeof(Entry));
+void HeartRateLogger::Unpack(Entry* buffer, uint16_t count) const {
+  // The packed records (timestamp + bpm) are smaller than Entry : they are read at the start of the buffer, and
+  // unpacked from the last one so that no record is overwritten before it is unpacked
+  static_assert(sizeof(uint32_t) + sizeof(Entry::bpm) <= sizeof(Entry), "Records do not fit in the entries");
+  const auto* records = reinterpret_cast<const uint8_t*>(buffer);
+  for (uint16_t i = count; i > 0; i--) {
+    const uint8_t* record = records + (i - 1) * store.RecordSize();
+    Entry entry;
+    std::memcpy(&entry.timestamp, record, sizeof(entry.timestamp));
+    entry.bpm = record[sizeof(entry.timestamp)];
+    buffer[i - 1] = entry;
   }
-
-  const_cast<FS&>(fs).FileClose(const_cast<lfs_file_t*>(&file));
-  return toRead;
 }
 
 uint16_t HeartRateLogger::GetEntryCount() const {
-  return header.count;
+  return static_cast<uint16_t>(store.Count());
 }
 
 void HeartRateLogger::Clear() {
-  header.writeIndex = 0;
-  header.count = 0;
   lastLogTimestamp = 0;
-  fs.FileDelete(filePath);
-  SaveHeader();
+  store.Clear();
 }
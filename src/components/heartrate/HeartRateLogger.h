@@ -1,10 +1,10 @@
 #pragma once
 
 #include <cstdint>
+#include "components/fs/TimeSeriesStore.h"
 
 namespace Pinetime {
   namespace Controllers {
-    class FS;
     class DateTime;
   }
 
@@ -16,34 +16,45 @@ namespace Pinetime {
         uint8_t bpm;
       };
 
-      HeartRateLogger(Controllers::FS& fs, Controllers::DateTime& dateTime);
+      HeartRateLogger(System::StorageTask& storage, Controllers::DateTime& dateTime);
 
       void Init();
       void AddMeasurement(uint8_t bpm);
+      // Writes the measurements that are still in RAM
+      void Flush();
       uint16_t GetRecentEntries(Entry* buffer, uint16_t maxCount) const;
+      // Entries with from <= timestamp < to (Unix time in seconds), oldest first
+      uint16_t GetEntries(uint32_t from, uint32_t to, Entry* buffer, uint16_t maxCount) const;
       uint16_t GetEntryCount() const;
       void Clear();
 
-      static constexpr uint16_t maxEntries = 480;
+      static constexpr uint16_t entriesPerSegment = 120;
+      static constexpr uint8_t nbSegments = 5;
+      static constexpr uint16_t maxEntries = entriesPerSegment * (nbSegments - 1);
 
     private:
       static constexpr const char* dirPath = "/.system";
-      static constexpr const char* filePath = "/.system/hrlog.dat";
-
-      struct FileHeader {
-        uint8_t version = 1;
-        uint16_t writeIndex = 0;
-        uint16_t count = 0;
+      static constexpr const char* logPath = "/.system/hr";
+      // Log file of the previous versions, replaced by the segments in logPath : a header followed by a ring buffer
+      // of legacyMaxEntries entries
+      static constexpr const char* legacyFilePath = "/.system/hrlog.dat";
+      static constexpr uint16_t legacyMaxEntries = 480;
+
+      struct LegacyHeader {
+        uint8_t version;
+        uint16_t writeIndex;
+        uint16_t count;
       };
+      // Measurements kept in RAM before they are written, about 2 minutes
+      static constexpr uint8_t batchSize = 4;
+
+      void Unpack(Entry* buffer, uint16_t count) const;
+      void ImportLegacyLog();
 
-      Controllers::FS& fs;
+      System::StorageTask& storage;
       Controllers::DateTime& dateTime;
-      FileHeader header;
+      TimeSeriesStore store;
       uint32_t lastLogTimestamp = 0;
-
-      void LoadHeader();
-      void SaveHeader();
-      void WriteEntry(const Entry& entry);
     };
   }
 }
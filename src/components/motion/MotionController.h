@@ -7,6 +7,7 @@
 #include "drivers/Bma421.h"
 #include "components/ble/MotionService.h"
 #include "utility/CircularBuffer.h"
+#include "utility/DataChangeNotifier.h"
 
 namespace Pinetime {
   namespace Controllers {
@@ -74,6 +75,10 @@ namespace Pinetime {
         return service;
       }
 
+      void Subscribe(Utility::DataChangeListener* listener) {
+        changeNotifier.Subscribe(listener);
+      }
+
     private:
       Utility::CircularBuffer<uint32_t, stepHistorySize> nbSteps = {0};
       uint32_t currentTripSteps = 0;
@@ -112,6 +117,7 @@ namespace Pinetime {
 
       DeviceTypes deviceType = DeviceTypes::Unknown;
       Pinetime::Controllers::MotionService* service = nullptr;
+      Utility::DataChangeNotifier changeNotifier {Utility::DataSource::Motion};
     };
   }
 }
@@ -1,10 +1,13 @@
 #include "components/settings/Settings.h"
 #include <cstdlib>
 #include <cstring>
+#include "nrf_assert.h"
 
 using namespace Pinetime::Controllers;
 
 Settings::Settings(Pinetime::Controllers::FS& fs) : fs {fs} {
+  mutex = xSemaphoreCreateMutex();
+  ASSERT(mutex != nullptr);
 }
 
 void Settings::Init() {
@@ -14,34 +17,94 @@ void Settings::Init() {
 }
 
 void Settings::SaveSettings() {
+  xSemaphoreTake(mutex, portMAX_DELAY);
 
   // verify if is necessary to save
   if (settingsChanged) {
     SaveSettingsToFile();
   }
   settingsChanged = false;
+
+  xSemaphoreGive(mutex);
+}
+
+template <typename Visitor>
+void Settings::ForEachSetting(Visitor&& visit) {
+  visit(Keys::StepsGoal, &SettingsData::stepsGoal);
+  visit(Keys::ScreenTimeOut, &SettingsData::screenTimeOut);
+  visit(Keys::AlwaysOnDisplay, &SettingsData::alwaysOnDisplay);
+  visit(Keys::ClockType, &SettingsData::clockType);
+  visit(Keys::WeatherFormat, &SettingsData::weatherFormat);
+  visit(Keys::NotificationStatus, &SettingsData::notificationStatus);
+  visit(Keys::WatchFace, &SettingsData::watchFace);
+  visit(Keys::ChimesOption, &SettingsData::chimesOption);
+  visit(Keys::PineTimeStyle, &SettingsData::PTS);
+  visit(Keys::PrideFlag, &SettingsData::prideFlag);
+  visit(Keys::WatchFaceInfineat, &SettingsData::watchFaceInfineat);
+  visit(Keys::WakeUpMode, &SettingsData::wakeUpMode);
+  visit(Keys::ShakeWakeThreshold, &SettingsData::shakeWakeThreshold);
+  visit(Keys::BrightLevel, &SettingsData::brightLevel);
+  visit(Keys::DfuAndFsEnabledOnBoot, &SettingsData::dfuAndFsEnabledOnBoot);
+  visit(Keys::HeartRateBackgroundPeriod, &SettingsData::heartRateBackgroundPeriod);
 }
 
 void Settings::LoadSettingsFromFile() {
+  lfs_info info;
+  if (fs.Stat(settingsPath, &info) != LFS_ERR_OK) {
+    // First boot with this version: import the legacy settings file if it is compatible, and store every setting
+    LoadLegacySettings();
+    CreateSettingsFile();
+    std::memset(&savedSettings, 0xFF, sizeof(SettingsData));
+    SaveSettingsToFile();
+    fs.FileDelete(legacySettingsPath);
+    return;
+  }
+
+  ForEachSetting([this](Keys key, auto member) {
+    auto value = settings.*member;
+    if (fs.GetAttribute(settingsPath, static_cast<uint8_t>(key), &value, sizeof(value)) == sizeof(value)) {
+      settings.*member = value;
+    }
+  });
+  std::memcpy(&savedSettings, &settings, sizeof(SettingsData));
+}
+
+bool Settings::LoadLegacySettings() {
   SettingsData bufferSettings;
   lfs_file_t settingsFile;
 
-  if (fs.FileOpen(&settingsFile, "/settings.dat", LFS_O_RDONLY) != LFS_ERR_OK) {
-    return;
+  if (fs.FileOpen(&settingsFile, legacySettingsPath, LFS_O_RDONLY) != LFS_ERR_OK) {
+    return false;
   }
   fs.FileRead(&settingsFile, reinterpret_cast<uint8_t*>(&bufferSettings), sizeof(settings));
   fs.FileClose(&settingsFile);
-  if (bufferSettings.version == settingsVersion) {
-    settings = bufferSettings;
+  if (bufferSettings.version != settingsVersion) {
+    return false;
   }
+  settings = bufferSettings;
+  return true;
 }
 
-void Settings::SaveSettingsToFile() {
+void Settings::CreateSettingsFile() {
   lfs_file_t settingsFile;
 
-  if (fs.FileOpen(&settingsFile, "/settings.dat", LFS_O_WRONLY | LFS_O_CREAT) != LFS_ERR_OK) {
+  fs.DirCreate(settingsDirPath);
+  if (fs.FileOpen(&settingsFile, settingsPath, LFS_O_WRONLY | LFS_O_CREAT) != LFS_ERR_OK) {
     return;
   }
-  fs.FileWrite(&settingsFile, reinterpret_cast<uint8_t*>(&settings), sizeof(settings));
   fs.FileClose(&settingsFile);
 }
+
+// Only the settings that differ from the stored values are written
+void Settings::SaveSettingsToFile() {
+  ForEachSetting([this](Keys key, auto member) {
+    const auto& value = settings.*member;
+    auto& saved = savedSettings.*member;
+    if (std::memcmp(&value, &saved, sizeof(value)) == 0) {
+      return;
+    }
+    if (fs.SetAttribute(settingsPath, static_cast<uint8_t>(key), &value, sizeof(value)) == LFS_ERR_OK) {
+      std::memcpy(&saved, &value, sizeof(value));
+    }
+  });
+}
@@ -5,7 +5,10 @@
 #include <optional>
 #include "components/brightness/BrightnessController.h"
 #include "components/fs/FS.h"
+#include <FreeRTOS.h>
+#include <semphr.h>
 #include "displayapp/apps/Apps.h"
+#include "utility/DataChangeNotifier.h"
 #include <nrf_log.h>
 
 namespace Pinetime {
@@ -188,6 +191,7 @@ namespace Pinetime {
       void SetClockType(ClockType clocktype) {
         if (clocktype != settings.clockType) {
           settingsChanged = true;
+          timeFormatNotifier.Notify();
         }
         settings.clockType = clocktype;
       };
@@ -351,10 +355,45 @@ namespace Pinetime {
         settings.heartRateBackgroundPeriod = newIntervalInSeconds.value();
       }
 
+      // Notified as a change of the time when the clock type changes
+      void Subscribe(Utility::DataChangeListener* listener) {
+        timeFormatNotifier.Subscribe(listener);
+      }
+
     private:
       Pinetime::Controllers::FS& fs;
+      Utility::DataChangeNotifier timeFormatNotifier {Utility::DataSource::Time};
 
+      // Version of the legacy settings file (/settings.dat), which contained the whole SettingsData structure.
+      // It is only read once, to import the settings into the attributes of settingsPath.
       static constexpr uint32_t settingsVersion = 0x000a;
+      static constexpr const char* legacySettingsPath = "/settings.dat";
+
+      // Each setting is stored in its own littlefs attribute of this file: a change is appended to the metadata log
+      // of the directory (compacted by littlefs when it is full), instead of rewriting all the settings
+      static constexpr const char* settingsDirPath = "/.system";
+      static constexpr const char* settingsPath = "/.system/settings";
+
+      // Attribute types of the settings. A value is only loaded if its size did not change: never reuse a key,
+      // use a new one if the type of a setting changes. Settings without a stored value keep their default value.
+      enum class Keys : uint8_t {
+        StepsGoal = 1,
+        ScreenTimeOut = 2,
+        AlwaysOnDisplay = 3,
+        ClockType = 4,
+        WeatherFormat = 5,
+        NotificationStatus = 6,
+        WatchFace = 7,
+        ChimesOption = 8,
+        PineTimeStyle = 9,
+        PrideFlag = 10,
+        WatchFaceInfineat = 11,
+        WakeUpMode = 12,
+        ShakeWakeThreshold = 13,
+        BrightLevel = 14,
+        DfuAndFsEnabledOnBoot = 15,
+        HeartRateBackgroundPeriod = 16,
+      };
 
       struct SettingsData {
         uint32_t version = settingsVersion;
@@ -386,7 +425,10 @@ namespace Pinetime {
       };
 
       SettingsData settings;
+      // Values currently stored in flash
+      SettingsData savedSettings;
       bool settingsChanged = false;
+      SemaphoreHandle_t mutex;
 
       uint8_t appMenu = 0;
       uint8_t settingsMenu = 0;
@@ -397,7 +439,11 @@ namespace Pinetime {
       bool bleRadioEnabled = true;
       bool dfuAndFsEnabledTillReboot = false;
 
+      template <typename Visitor>
+      static void ForEachSetting(Visitor&& visit);
       void LoadSettingsFromFile();
+      bool LoadLegacySettings();
+      void CreateSettingsFile();
       void SaveSettingsToFile();
     };
   }
@@ -3,6 +3,7 @@
 namespace Pinetime {
   namespace Applications {
     class DisplayApp;
+    class FontCache;
   }
 
   namespace Components {
@@ -57,6 +58,7 @@ namespace Pinetime {
       Pinetime::Controllers::MusicService* musicService;
       Pinetime::Controllers::NavigationService* navigationService;
       Pinetime::Controllers::HeartRateLogger& heartRateLogger;
+      Pinetime::Applications::FontCache& fontCache;
     };
   }
 }
@@ -119,6 +119,7 @@ DisplayApp::DisplayApp(Drivers::St7789& lcd,
     heartRateLogger {heartRateLogger},
     lvgl {lcd, filesystem},
     timer(this, TimerCallback),
+    fontCache {filesystem},
     controllers {batteryController,
                  bleController,
                  dateTimeController,
@@ -139,7 +140,8 @@ DisplayApp::DisplayApp(Drivers::St7789& lcd,
                  lvgl,
                  nullptr,
                  nullptr,
-                 heartRateLogger} {
+                 heartRateLogger,
+                 fontCache} {
 }
 
 void DisplayApp::Start(System::BootErrors error) {
@@ -249,8 +251,11 @@ void DisplayApp::Refresh() {
       queueTimeout = portMAX_DELAY;
       break;
     case States::AOD:
+      // Frames are paced by CalculateSleepTime()
+      lvgl.UpdateIdleState(true);
       if (!currentScreen->IsRunning()) {
         LoadPreviousScreen();
+        ApplyAlwaysOnArea();
       }
       // Check we've slept long enough
       // Might not be true if the loop received an event
@@ -273,7 +278,22 @@ void DisplayApp::Refresh() {
       if (!currentScreen->IsRunning()) {
         LoadPreviousScreen();
       }
+      // The messages handled since the last call may have changed the screen
+      lvgl.BorrowTransitionBuffers();
+      // The transition buffers may have left less than minFreeHeap
+      fontCache.Trim();
+      lvgl.UpdateIdleState(touchHandler.IsTouching());
       queueTimeout = lv_task_handler();
+      if (!lvgl.UpdateIdleState(touchHandler.IsTouching())) {
+        queueTimeout = std::min<TickType_t>(queueTimeout, LV_DISP_DEF_REFR_PERIOD);
+      } else {
+        // Wake up in time to dim the screen or to go to sleep
+        const uint32_t inactiveTime = lv_disp_get_inactive_time(nullptr);
+        const uint32_t nextTimeout = pdMS_TO_TICKS(settingsController.GetScreenTimeOut() - (isDimmed ? 0 : 2000));
+        if (inactiveTime < nextTimeout) {
+          queueTimeout = std::min<TickType_t>(queueTimeout, nextTimeout - inactiveTime);
+        }
+      }
 
       if (!systemTask->IsSleepDisabled() && IsPastDimTime()) {
         if (!isDimmed) {
@@ -343,11 +363,13 @@ void DisplayApp::Refresh() {
         lvgl.ClearTouchState();
         if (msg == Messages::GoToAOD) {
           lcd.LowPowerOn();
+          ApplyAlwaysOnArea();
           // Record idle entry time
           alwaysOnFrameCount = 0;
           alwaysOnStartTime = xTaskGetTickCount();
           PushMessageToSystemTask(Pinetime::System::Messages::OnDisplayTaskAOD);
           state = States::AOD;
+          ApplyColorDepth();
         } else {
           lcd.Sleep();
           PushMessageToSystemTask(Pinetime::System::Messages::OnDisplayTaskSleeping);
@@ -365,6 +387,7 @@ void DisplayApp::Refresh() {
           break;
         }
         if (state == States::AOD) {
+          lvgl.ClearPartialArea();
           lcd.LowPowerOff();
         } else {
           lcd.Wakeup();
@@ -372,6 +395,7 @@ void DisplayApp::Refresh() {
         lv_disp_trig_activity(nullptr);
         ApplyBrightness();
         state = States::Running;
+        ApplyColorDepth();
         break;
       case Messages::UpdateBleConnection:
         // Only used for recovery firmware
@@ -503,6 +527,12 @@ void DisplayApp::Refresh() {
         LoadNewScreen(Apps::Clock, DisplayApp::FullRefreshDirections::None);
         motorController.RunForDuration(35);
         break;
+      case Messages::DataChanged:
+        // Handled by DispatchDataChanges() below, the message is only used to wake the task up
+        break;
+      case Messages::ResourcesChanged:
+        fontCache.Clear();
+        break;
     }
   }
 
@@ -510,6 +540,9 @@ void DisplayApp::Refresh() {
     currentScreen->OnTouchEvent(touchHandler.GetX(), touchHandler.GetY());
   }
 
+  DispatchDataChanges();
+  CountWakeup();
+
   if (nextApp != Apps::None) {
     LoadNewScreen(nextApp, nextDirection);
     nextApp = Apps::None;
@@ -538,7 +571,12 @@ void DisplayApp::LoadScreen(Apps app, DisplayApp::FullRefreshDirections directio
   motorController.StopRinging();
 
   currentScreen.reset(nullptr);
+  // The fonts of the previous screen stay loaded while there is enough memory for the next one
+  fontCache.TrimForNewScreen();
   SetFullRefresh(direction);
+  // Includes the loading of the fonts and images of the screen
+  TickType_t loadStartTicks = xTaskGetTickCount();
+  const size_t freeHeapBeforeScreen = xPortGetFreeHeapSize();
 
   switch (app) {
     case Apps::Launcher: {
@@ -664,7 +702,10 @@ void DisplayApp::LoadScreen(Apps app, DisplayApp::FullRefreshDirections directio
                                                             watchdog,
                                                             motionController,
                                                             touchPanel,
-                                                            spiNorFlash);
+                                                            spiNorFlash,
+                                                            filesystem,
+                                                            systemTask->nimble().connectionParameters(),
+                                                            systemTask->nimble().notifications());
       break;
     case Apps::FlashLight:
       currentScreen = std::make_unique<Screens::FlashLight>(*systemTask, brightnessController);
@@ -682,6 +723,11 @@ void DisplayApp::LoadScreen(Apps app, DisplayApp::FullRefreshDirections directio
     }
   }
   currentApp = app;
+  fontCache.OnScreenCreated(freeHeapBeforeScreen - std::min(freeHeapBeforeScreen, xPortGetFreeHeapSize()));
+  ApplyColorDepth();
+  NRF_LOG_INFO("[DisplayApp] Screen %d loaded in %d ms",
+               static_cast<int>(app),
+               (xTaskGetTickCount() - loadStartTicks) * 1000 / configTICK_RATE_HZ);
 }
 
 void DisplayApp::PushMessage(Messages msg) {
@@ -694,7 +740,7 @@ void DisplayApp::PushMessage(Messages msg) {
     // Make xQueueSend() non-blocking if the message is a Notification message. We do this to avoid
     // deadlock between SystemTask and DisplayApp when their respective message queues are getting full
     // when a lot of notifications are received on a very short time span.
-    if (msg == Messages::NewNotification) {
+    if (msg == Messages::NewNotification || msg == Messages::DataChanged) {
       timeout = static_cast<TickType_t>(0);
     }
 
@@ -750,6 +796,52 @@ void DisplayApp::Register(Pinetime::Controllers::NavigationService* NavigationSe
   this->controllers.navigationService = NavigationService;
 }
 
+void DisplayApp::OnDataChanged(Utility::DataSource source) {
+  uint32_t previous = pendingDataChanges.fetch_or(1U << static_cast<uint8_t>(source));
+  // Only wake the task for the first change of a batch. While the display is off, changes
+  // accumulate and are dispatched on the next wakeup.
+  if (previous == 0 && state != States::Idle) {
+    PushMessage(Messages::DataChanged);
+  }
+}
+
+void DisplayApp::DispatchDataChanges() {
+  if (state == States::Idle) {
+    return;
+  }
+  uint32_t changes = pendingDataChanges.exchange(0);
+  if (changes != 0) {
+    currentScreen->OnDataChanged(Utility::DataSources {changes});
+  }
+}
+
+void DisplayApp::CountWakeup() {
+  wakeupCount++;
+  TickType_t now = xTaskGetTickCount();
+  if (now - wakeupWindowStart >= pdMS_TO_TICKS(60 * 1000)) {
+    NRF_LOG_INFO("[displayapp] %lu wakeups in the last minute", wakeupCount);
+    wakeupCount = 0;
+    wakeupWindowStart = now;
+  }
+}
+
+void DisplayApp::ApplyAlwaysOnArea() {
+  if (auto area = currentScreen->AlwaysOnArea(); area.has_value()) {
+    lvgl.SetPartialArea(*area);
+  } else {
+    lvgl.ClearPartialArea();
+  }
+}
+
+void DisplayApp::ApplyColorDepth() {
+  // Colours are barely distinguishable at always on brightness, so AOD always uses the cheaper format
+  if (state == States::AOD || currentScreen->UseReducedColorDepth()) {
+    lvgl.SetColorDepth(Drivers::St7789::ColorDepth::Rgb444);
+  } else {
+    lvgl.SetColorDepth(Drivers::St7789::ColorDepth::Rgb565);
+  }
+}
+
 void DisplayApp::ApplyBrightness() {
   auto brightness = settingsController.GetBrightness();
   if (brightness != Controllers::BrightnessController::Levels::Low && brightness != Controllers::BrightnessController::Levels::Medium &&
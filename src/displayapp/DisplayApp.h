@@ -2,10 +2,12 @@
 #include <FreeRTOS.h>
 #include <queue.h>
 #include <task.h>
+#include <atomic>
 #include <memory>
 #include <systemtask/Messages.h>
 #include "displayapp/apps/Apps.h"
 #include "displayapp/LittleVgl.h"
+#include "displayapp/FontCache.h"
 #include "displayapp/TouchEvents.h"
 #include "components/brightness/BrightnessController.h"
 #include "components/motor/MotorController.h"
@@ -22,6 +24,7 @@
 #include "BootErrors.h"
 
 #include "utility/StaticStack.h"
+#include "utility/DataChangeNotifier.h"
 #include "displayapp/Controllers.h"
 
 namespace Pinetime {
@@ -49,7 +52,7 @@ namespace Pinetime {
   };
 
   namespace Applications {
-    class DisplayApp {
+    class DisplayApp : public Utility::DataChangeListener {
     public:
       enum class States { Idle, Running, AOD };
       enum class FullRefreshDirections { None, Up, Down, Left, Right, LeftAnim, RightAnim };
@@ -85,6 +88,8 @@ namespace Pinetime {
       void Register(Pinetime::Controllers::MusicService* musicService);
       void Register(Pinetime::Controllers::NavigationService* NavigationService);
 
+      void OnDataChanged(Utility::DataSource source) override;
+
     private:
       Pinetime::Drivers::St7789& lcd;
       const Pinetime::Drivers::Cst816S& touchPanel;
@@ -110,6 +115,7 @@ namespace Pinetime {
       Pinetime::Controllers::FirmwareValidator validator;
       Pinetime::Components::LittleVgl lvgl;
       Pinetime::Controllers::Timer timer;
+      FontCache fontCache;
 
       AppControllers controllers;
       TaskHandle_t taskHandle;
@@ -139,6 +145,8 @@ namespace Pinetime {
       DisplayApp::FullRefreshDirections nextDirection;
       System::BootErrors bootError;
       void ApplyBrightness();
+      void ApplyAlwaysOnArea();
+      void ApplyColorDepth();
 
       static constexpr size_t returnAppStackSize = 10;
       Utility::StaticStack<Apps, returnAppStackSize> returnAppStack;
@@ -146,6 +154,15 @@ namespace Pinetime {
 
       bool isDimmed = false;
 
+      // Bitmask of Utility::DataSource changed since the current screen was last notified
+      std::atomic<uint32_t> pendingDataChanges {0};
+      void DispatchDataChanges();
+
+      // Number of times the task woke up in the current one minute window, logged for power tuning
+      uint32_t wakeupCount = 0;
+      TickType_t wakeupWindowStart = 0;
+      void CountWakeup();
+
       TickType_t CalculateSleepTime();
       TickType_t alwaysOnFrameCount;
       TickType_t alwaysOnStartTime;
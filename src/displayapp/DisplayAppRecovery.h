@@ -12,6 +12,7 @@
 #include "displayapp/TouchEvents.h"
 #include "displayapp/apps/Apps.h"
 #include "displayapp/Messages.h"
+#include "utility/DataChangeNotifier.h"
 
 namespace Pinetime {
   namespace Drivers {
@@ -45,7 +46,7 @@ namespace Pinetime {
   };
 
   namespace Applications {
-    class DisplayApp {
+    class DisplayApp : public Utility::DataChangeListener {
     public:
       DisplayApp(Drivers::St7789& lcd,
                  const Drivers::Cst816S&,
@@ -76,6 +77,9 @@ namespace Pinetime {
       void Register(Pinetime::Controllers::MusicService* musicService);
       void Register(Pinetime::Controllers::NavigationService* NavigationService);
 
+      void OnDataChanged(Utility::DataSource /*source*/) override {
+      }
+
     private:
       TaskHandle_t taskHandle;
       static void Process(void* instance);
@@ -0,0 +1,143 @@
+#include "displayapp/FontCache.h"
+#include <FreeRTOS.h>
+#include <algorithm>
+#include <cstdio>
+#include <libraries/log/nrf_log.h>
+#include "components/fs/AssetPartition.h"
+#include "components/fs/FS.h"
+
+using namespace Pinetime::Applications;
+
+FontCache::FontCache(Controllers::FS& filesystem) : filesystem {filesystem} {
+}
+
+lv_font_t* FontCache::Get(const char* path) {
+  const uint32_t hash = Controllers::AssetPartition::Hash(path);
+  auto entry = std::ranges::find_if(entries, [hash](const Entry& e) {
+    return e.font != nullptr && e.hash == hash;
+  });
+  Entry* font = (entry != entries.end()) ? &*entry : Load(path, hash);
+  if (font == nullptr) {
+    return nullptr;
+  }
+  font->references++;
+  font->lastUse = ++useCounter;
+  return font->font;
+}
+
+FontCache::Entry* FontCache::Load(const char* path, uint32_t hash) {
+  // LVGL crashes when trying to open a font that doesn't exist
+  if (!filesystem.AssetExists(path)) {
+    return nullptr;
+  }
+  char drivePath[maxPathSize];
+  if (snprintf(drivePath, sizeof(drivePath), "A:%s", path) >= static_cast<int>(sizeof(drivePath))) {
+    return nullptr;
+  }
+
+  auto slot = std::ranges::find_if(entries, [](const Entry& e) {
+    return e.font == nullptr;
+  });
+  Entry* entry = (slot != entries.end()) ? &*slot : Oldest();
+  if (entry == nullptr) {
+    NRF_LOG_INFO("[FontCache] No room for %s", path);
+    return nullptr;
+  }
+  if (entry->font != nullptr) {
+    Free(*entry);
+  }
+
+  size_t freeHeap = xPortGetFreeHeapSize();
+  lv_font_t* font = lv_font_load(drivePath);
+  if (font == nullptr) {
+    // Probably out of memory, try again without the released fonts
+    Clear();
+    freeHeap = xPortGetFreeHeapSize();
+    font = lv_font_load(drivePath);
+    if (font == nullptr) {
+      NRF_LOG_INFO("[FontCache] Failed to load %s", path);
+      return nullptr;
+    }
+  }
+  // Approximation : the other tasks may allocate during the loading
+  const size_t size = freeHeap - std::min(freeHeap, xPortGetFreeHeapSize());
+  NRF_LOG_INFO("[FontCache] %s loaded, %d bytes", path, size);
+
+  *entry = {hash, font, size, 0, 0};
+  return entry;
+}
+
+void FontCache::Release(lv_font_t* font) {
+  if (font == nullptr) {
+    return;
+  }
+  auto entry = std::ranges::find_if(entries, [font](const Entry& e) {
+    return e.font == font;
+  });
+  if (entry != entries.end() && entry->references > 0) {
+    entry->references--;
+  }
+
+  while (ReleasedSize() > cacheBudget) {
+    Entry* oldest = Oldest();
+    if (oldest == nullptr) {
+      break;
+    }
+    Free(*oldest);
+  }
+}
+
+void FontCache::Trim() {
+  TrimTo(minFreeHeap);
+}
+
+void FontCache::TrimForNewScreen() {
+  TrimTo(minFreeHeap + largestScreen);
+}
+
+void FontCache::OnScreenCreated(size_t heapUsed) {
+  largestScreen = std::max(largestScreen, heapUsed);
+}
+
+void FontCache::TrimTo(size_t freeHeap) {
+  while (xPortGetFreeHeapSize() < freeHeap) {
+    Entry* oldest = Oldest();
+    if (oldest == nullptr) {
+      break;
+    }
+    Free(*oldest);
+  }
+}
+
+void FontCache::Clear() {
+  for (auto& entry : entries) {
+    if (entry.font != nullptr && entry.references == 0) {
+      Free(entry);
+    }
+  }
+}
+
+void FontCache::Free(Entry& entry) {
+  lv_font_free(entry.font);
+  entry = {};
+}
+
+FontCache::Entry* FontCache::Oldest() {
+  Entry* oldest = nullptr;
+  for (auto& entry : entries) {
+    if (entry.font != nullptr && entry.references == 0 && (oldest == nullptr || entry.lastUse < oldest->lastUse)) {
+      oldest = &entry;
+    }
+  }
+  return oldest;
+}
+
+size_t FontCache::ReleasedSize() const {
+  size_t size = 0;
+  for (const auto& entry : entries) {
+    if (entry.font != nullptr && entry.references == 0) {
+      size += entry.size;
+    }
+  }
+  return size;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <lvgl/lvgl.h>
+
+namespace Pinetime {
+  namespace Controllers {
+    class FS;
+  }
+
+  namespace Applications {
+    /** Fonts of the external resources loaded by lv_font_load(), shared by the screens.
+     *
+     * lv_font_load() parses the whole file and copies the glyphs in the heap, which takes a while for the large
+     * fonts of the watch faces. The fonts are kept loaded when they are released, so that going back to the watch
+     * face does not load them again. The released fonts are freed, least recently used first, when they use more
+     * than cacheBudget bytes, or when they leave too little heap for the next screen or for the transition buffers.
+     *
+     * Only used from the display task. */
+    class FontCache {
+    public:
+      explicit FontCache(Controllers::FS& filesystem);
+
+      // Path of the font in the external resources ("/fonts/font.bin"). Return nullptr if the font is not available.
+      // Each font returned must be released with Release().
+      lv_font_t* Get(const char* path);
+      void Release(lv_font_t* font);
+
+      // Frees released fonts until the free heap is back over minFreeHeap
+      void Trim();
+      // Same as Trim(), with room for the largest screen created so far on top of minFreeHeap
+      void TrimForNewScreen();
+      // Heap taken by the creation of a screen, fonts included
+      void OnScreenCreated(size_t heapUsed);
+      // Frees all the released fonts, their file may have been replaced
+      void Clear();
+
+    private:
+      struct Entry {
+        // AssetPartition::Hash() of the path, 0 if the entry is empty
+        uint32_t hash = 0;
+        lv_font_t* font = nullptr;
+        // Heap used by the font
+        size_t size = 0;
+        uint8_t references = 0;
+        uint32_t lastUse = 0;
+      };
+
+      static constexpr uint8_t maxFonts = 8;
+      static constexpr size_t cacheBudget = 16 * 1024;
+      static constexpr size_t minFreeHeap = 8 * 1024;
+      static constexpr size_t maxPathSize = 40;
+
+      Entry* Load(const char* path, uint32_t hash);
+      void Free(Entry& entry);
+      // Least recently used released font, nullptr if all the fonts are in use
+      Entry* Oldest();
+      size_t ReleasedSize() const;
+      void TrimTo(size_t freeHeap);
+
+      Controllers::FS& filesystem;
+      std::array<Entry, maxFonts> entries;
+      uint32_t useCounter = 0;
+      size_t largestScreen = 0;
+    };
+  }
+}
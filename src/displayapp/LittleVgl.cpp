@@ -3,6 +3,8 @@
 
 #include <FreeRTOS.h>
 #include <task.h>
+#include <algorithm>
+#include <libraries/log/nrf_log.h>
 #include "drivers/St7789.h"
 #include "littlefs/lfs.h"
 #include "components/fs/FS.h"
@@ -51,6 +53,58 @@ namespace {
     filesys->FileSeek(file, pos);
     return LV_FS_RES_OK;
   }
+
+  // Driver of the 'A' letter : the assets are read directly from the asset partition, or from the filesystem if
+  // the partition does not contain them
+  struct AssetFile {
+    bool inPartition;
+    Pinetime::Controllers::AssetPartition::Asset asset;
+    uint32_t position;
+    lfs_file_t file;
+  };
+
+  lv_fs_res_t lvglAssetOpen(lv_fs_drv_t* drv, void* file_p, const char* path, lv_fs_mode_t mode) {
+    auto* file = static_cast<AssetFile*>(file_p);
+    auto* filesys = static_cast<Pinetime::Controllers::FS*>(drv->user_data);
+    file->position = 0;
+    file->inPartition = filesys->AssetOpen(path, file->asset);
+    if (file->inPartition) {
+      return LV_FS_RES_OK;
+    }
+    return lvglOpen(drv, &file->file, path, mode);
+  }
+
+  lv_fs_res_t lvglAssetClose(lv_fs_drv_t* drv, void* file_p) {
+    auto* file = static_cast<AssetFile*>(file_p);
+    if (file->inPartition) {
+      return LV_FS_RES_OK;
+    }
+    return lvglClose(drv, &file->file);
+  }
+
+  lv_fs_res_t lvglAssetRead(lv_fs_drv_t* drv, void* file_p, void* buf, uint32_t btr, uint32_t* br) {
+    auto* file = static_cast<AssetFile*>(file_p);
+    if (!file->inPartition) {
+      return lvglRead(drv, &file->file, buf, btr, br);
+    }
+    auto* filesys = static_cast<Pinetime::Controllers::FS*>(drv->user_data);
+    *br = filesys->AssetRead(file->asset, file->position, buf, btr);
+    if (*br == 0 && btr > 0 && file->position < file->asset.size) {
+      // A new asset image was installed since the file was opened
+      return LV_FS_RES_HW_ERR;
+    }
+    file->position += *br;
+    return LV_FS_RES_OK;
+  }
+
+  lv_fs_res_t lvglAssetSeek(lv_fs_drv_t* drv, void* file_p, uint32_t pos) {
+    auto* file = static_cast<AssetFile*>(file_p);
+    if (!file->inPartition) {
+      return lvglSeek(drv, &file->file, pos);
+    }
+    file->position = std::min(pos, file->asset.size);
+    return LV_FS_RES_OK;
+  }
 }
 
 static void disp_flush(lv_disp_drv_t* disp_drv, const lv_area_t* area, lv_color_t* color_p) {
@@ -66,6 +120,17 @@ static void rounder(lv_disp_drv_t* disp_drv, lv_area_t* area) {
     area->y1 = 0;
     area->y2 = LV_VER_RES - 1;
   }
+  lvgl->ClipToPartialArea(area);
+  if (lvgl->GetColorDepth() == Pinetime::Drivers::St7789::ColorDepth::Rgb444) {
+    // 2 pixels are packed in 3 bytes, keep an even number of pixels per line so that every flush ends on a byte boundary
+    area->x1 &= ~1;
+    area->x2 |= 1;
+  }
+}
+
+static void monitor(lv_disp_drv_t* disp_drv, uint32_t time, uint32_t px) {
+  auto* lvgl = static_cast<LittleVgl*>(disp_drv->user_data);
+  lvgl->OnRefreshDone(time, px);
 }
 
 bool touchpad_read(lv_indev_drv_t* indev_drv, lv_indev_data_t* data) {
@@ -85,8 +150,8 @@ void LittleVgl::Init() {
 }
 
 void LittleVgl::InitDisplay() {
-  lv_disp_buf_init(&disp_buf_2, buf2_1, buf2_2, LV_HOR_RES_MAX * 4); /*Initialize the display buffer*/
-  lv_disp_drv_init(&disp_drv);                                       /*Basic initialization*/
+  lv_disp_buf_init(&disp_buf_2, buf2_1, buf2_2, LV_HOR_RES_MAX * nbWriteLines); /*Initialize the display buffer*/
+  lv_disp_drv_init(&disp_drv);                                                  /*Basic initialization*/
 
   /*Set up the functions to access to your display*/
 
@@ -100,9 +165,10 @@ void LittleVgl::InitDisplay() {
   disp_drv.buffer = &disp_buf_2;
   disp_drv.user_data = this;
   disp_drv.rounder_cb = rounder;
+  disp_drv.monitor_cb = monitor;
 
   /*Finally register the driver*/
-  lv_disp_drv_register(&disp_drv);
+  disp = lv_disp_drv_register(&disp_drv);
 }
 
 void LittleVgl::InitTouchpad() {
@@ -112,7 +178,22 @@ void LittleVgl::InitTouchpad() {
   indev_drv.type = LV_INDEV_TYPE_POINTER;
   indev_drv.read_cb = touchpad_read;
   indev_drv.user_data = this;
-  lv_indev_drv_register(&indev_drv);
+  indev = lv_indev_drv_register(&indev_drv);
+}
+
+bool LittleVgl::UpdateIdleState(bool keepActive) {
+  bool isIdle = !keepActive && disp->inv_p == 0 && lv_anim_count_running() == 0 && lv_disp_get_inactive_time(disp) >= activeDelay;
+  if (isIdle != idle) {
+    idle = isIdle;
+    const uint32_t period = idle ? idleRefreshPeriod : LV_DISP_DEF_REFR_PERIOD;
+    lv_task_set_period(disp->refr_task, period);
+    lv_task_set_period(indev->driver.read_task, period);
+    if (!idle) {
+      lv_task_ready(disp->refr_task);
+      lv_task_ready(indev->driver.read_task);
+    }
+  }
+  return idle;
 }
 
 void LittleVgl::InitFileSystem() {
@@ -129,6 +210,20 @@ void LittleVgl::InitFileSystem() {
   fs_drv.user_data = &filesystem;
 
   lv_fs_drv_register(&fs_drv);
+
+  lv_fs_drv_t assetDrv;
+  lv_fs_drv_init(&assetDrv);
+
+  assetDrv.file_size = sizeof(AssetFile);
+  assetDrv.letter = 'A';
+  assetDrv.open_cb = lvglAssetOpen;
+  assetDrv.close_cb = lvglAssetClose;
+  assetDrv.read_cb = lvglAssetRead;
+  assetDrv.seek_cb = lvglAssetSeek;
+
+  assetDrv.user_data = &filesystem;
+
+  lv_fs_drv_register(&assetDrv);
 }
 
 void LittleVgl::SetFullRefresh(FullRefreshDirections direction) {
@@ -145,14 +240,147 @@ void LittleVgl::SetFullRefresh(FullRefreshDirections direction) {
     } else if (scrollDirection == FullRefreshDirections::LeftAnim) {
       lv_disp_set_direction(lv_disp_get_default(), 4);
     }
+    if (scrollDirection != FullRefreshDirections::None) {
+      transitionStart = xTaskGetTickCount();
+      transitionFlushCount = 0;
+      transitionAddrWindowStart = lcd.AddrWindowCount();
+    }
   }
   fullRefresh = true;
 }
 
+void LittleVgl::BorrowTransitionBuffers() {
+  if (transitionBuffer != nullptr || scrollDirection == FullRefreshDirections::None) {
+    return;
+  }
+  // Transitions redraw the whole screen, larger bands mean fewer flushes and a faster animation.
+  // Only borrow what the heap can spare, band heights must divide the screen height for the scroll to line up.
+  for (uint8_t nbLines : {24, 12, 8}) {
+    size_t size = 2 * LV_HOR_RES_MAX * nbLines * sizeof(lv_color_t);
+    if (xPortGetFreeHeapSize() < size + minFreeHeapForTransitionBuffers) {
+      continue;
+    }
+    transitionBuffer = static_cast<lv_color_t*>(pvPortMalloc(size));
+    if (transitionBuffer != nullptr) {
+      lv_disp_buf_init(&disp_buf_2, transitionBuffer, transitionBuffer + (LV_HOR_RES_MAX * nbLines), LV_HOR_RES_MAX * nbLines);
+      return;
+    }
+  }
+}
+
+void LittleVgl::ReleaseTransitionBuffers() {
+  if (transitionBuffer == nullptr) {
+    return;
+  }
+  // The last band may still be in flight
+  lcd.SyncWrites();
+  lv_disp_buf_init(&disp_buf_2, buf2_1, buf2_2, LV_HOR_RES_MAX * nbWriteLines);
+  vPortFree(transitionBuffer);
+  transitionBuffer = nullptr;
+}
+
+void LittleVgl::OnRefreshDone(uint32_t /*time*/, uint32_t /*px*/) {
+  if (transitionStart == 0 || scrollDirection != FullRefreshDirections::None) {
+    return;
+  }
+  NRF_LOG_INFO("[LVGL] Transition: %lu ms, %lu flushes, %lu address windows, %u lines per band",
+               static_cast<unsigned long>((xTaskGetTickCount() - transitionStart) * 1000 / configTICK_RATE_HZ),
+               static_cast<unsigned long>(transitionFlushCount),
+               static_cast<unsigned long>(lcd.AddrWindowCount() - transitionAddrWindowStart),
+               static_cast<unsigned>(disp_buf_2.size / LV_HOR_RES_MAX));
+  transitionStart = 0;
+  ReleaseTransitionBuffers();
+}
+
 bool LittleVgl::IsScrolling() {
   return scrollDirection != LittleVgl::FullRefreshDirections::None;
 }
 
+void LittleVgl::SetPartialArea(const lv_area_t& area) {
+  partialArea.x1 = 0;
+  partialArea.x2 = LV_HOR_RES - 1;
+  partialArea.y1 = std::max<lv_coord_t>(area.y1, 0);
+  partialArea.y2 = std::min<lv_coord_t>(area.y2, LV_VER_RES - 1);
+  if (partialArea.y2 < partialArea.y1) {
+    ClearPartialArea();
+    return;
+  }
+  if (scrollDirection != FullRefreshDirections::None || writeOffset != 0 || scrollOffset != 0) {
+    // The partial area is given in screen lines, which only match the GRAM lines when the display is not scrolled.
+    // A transition left the screen shifted in GRAM: reset the scroll and redraw the area at its unscrolled position.
+    scrollDirection = FullRefreshDirections::None;
+    writeOffset = 0;
+    scrollOffset = 0;
+    lcd.VerticalScrollStartAddress(0);
+    lv_obj_invalidate(lv_scr_act());
+  }
+  partialMode = true;
+  lcd.PartialModeOn(partialArea.y1, partialArea.y2);
+}
+
+void LittleVgl::ClearPartialArea() {
+  if (!partialMode) {
+    return;
+  }
+  partialMode = false;
+  lcd.PartialModeOff();
+  // Lines outside of the partial area were not redrawn while it was active
+  lv_obj_invalidate(lv_scr_act());
+}
+
+void LittleVgl::SetColorDepth(Drivers::St7789::ColorDepth depth) {
+  // Only called between 2 calls to lv_task_handler(), so no flush can be using the previous format
+  if (depth != colorDepth) {
+    // The pending areas were rounded for the previous format, an odd width can't be sent in Rgb444.
+    // Replace them with the whole screen, which is rounded again for the new format.
+    disp->inv_p = 0;
+    colorDepth = depth;
+    lv_obj_invalidate(lv_scr_act());
+  }
+  lcd.SetColorDepth(depth);
+}
+
+size_t LittleVgl::BufferSize(size_t nbPixels) const {
+  if (colorDepth == Drivers::St7789::ColorDepth::Rgb444) {
+    return nbPixels * 3 / 2;
+  }
+  return nbPixels * 2;
+}
+
+void LittleVgl::PackRgb444(uint8_t* data, size_t nbPixels) {
+  // Pixels are byte swapped RGB565 (RRRRRGGG GGGBBBBB), packed in place as RRRRGGGG BBBBRRRR GGGGBBBB.
+  // The packed data is always shorter than the data read so far, so it never overwrites unread pixels.
+  const uint8_t* src = data;
+  uint8_t* dst = data;
+  for (size_t i = 0; i < nbPixels; i += 2) {
+    uint8_t r0 = src[0] >> 4;
+    uint8_t g0 = ((src[0] & 0x07) << 1) | (src[1] >> 7);
+    uint8_t b0 = (src[1] >> 1) & 0x0f;
+    uint8_t r1 = src[2] >> 4;
+    uint8_t g1 = ((src[2] & 0x07) << 1) | (src[3] >> 7);
+    uint8_t b1 = (src[3] >> 1) & 0x0f;
+    dst[0] = (r0 << 4) | g0;
+    dst[1] = (b0 << 4) | r1;
+    dst[2] = (g1 << 4) | b1;
+    src += 4;
+    dst += 3;
+  }
+}
+
+void LittleVgl::ClipToPartialArea(lv_area_t* area) const {
+  if (!partialMode) {
+    return;
+  }
+  lv_area_t clipped;
+  if (_lv_area_intersect(&clipped, area, &partialArea)) {
+    *area = clipped;
+  } else {
+    // The rounder can't discard an area, reduce it to a single column which is cheap to redraw instead.
+    // Its lines must be kept: LVGL also calls the rounder to compute how many lines fit in the draw buffer.
+    area->x2 = area->x1;
+  }
+}
+
 void LittleVgl::FlushDisplay(const lv_area_t* area, lv_color_t* color_p) {
   uint16_t y1, y2, width, height = 0;
 
@@ -214,19 +442,25 @@ void LittleVgl::FlushDisplay(const lv_area_t* area, lv_color_t* color_p) {
     }
   }
 
+  transitionFlushCount++;
+  auto* data = reinterpret_cast<uint8_t*>(color_p);
+  if (colorDepth == Drivers::St7789::ColorDepth::Rgb444) {
+    PackRgb444(data, width * height);
+  }
+
   if (y2 < y1) {
     height = totalNbLines - y1;
 
     if (height > 0) {
-      lcd.DrawBuffer(area->x1, y1, width, height, reinterpret_cast<const uint8_t*>(color_p), width * height * 2);
+      lcd.DrawBuffer(area->x1, y1, width, height, data, BufferSize(width * height));
     }
 
-    uint16_t pixOffset = width * height;
+    size_t byteOffset = BufferSize(width * height);
     height = y2 + 1;
-    lcd.DrawBuffer(area->x1, 0, width, height, reinterpret_cast<const uint8_t*>(color_p + pixOffset), width * height * 2);
+    lcd.DrawBuffer(area->x1, 0, width, height, data + byteOffset, BufferSize(width * height));
 
   } else {
-    lcd.DrawBuffer(area->x1, y1, width, height, reinterpret_cast<const uint8_t*>(color_p), width * height * 2);
+    lcd.DrawBuffer(area->x1, y1, width, height, data, BufferSize(width * height));
   }
 
   // IMPORTANT!!!
@@ -2,12 +2,9 @@
 
 #include <lvgl/lvgl.h>
 #include <components/fs/FS.h>
+#include "drivers/St7789.h"
 
 namespace Pinetime {
-  namespace Drivers {
-    class St7789;
-  }
-
   namespace Components {
     class LittleVgl {
     public:
@@ -29,6 +26,27 @@ namespace Pinetime {
       void ClearTouchState();
       bool IsScrolling();
 
+      // Restricts the panel to the lines covered by area, only those lines are redrawn and displayed
+      void SetPartialArea(const lv_area_t& area);
+      void ClearPartialArea();
+      void ClipToPartialArea(lv_area_t* area) const;
+      void OnRefreshDone(uint32_t time, uint32_t px);
+      // Allocates larger draw buffers if a transition is pending. Called once the new screen is built, so that the
+      // buffers only take the memory the screen left.
+      void BorrowTransitionBuffers();
+
+      // LVGL redraws the display and reads the touch panel every LV_DISP_DEF_REFR_PERIOD. While nothing has to be
+      // redrawn and the screen was not touched recently, these tasks only run every idleRefreshPeriod, so that
+      // DisplayApp sleeps until the next refresh task of the screen. Return true if LVGL is idle.
+      bool UpdateIdleState(bool keepActive);
+
+      // Rgb444 sends 25% less data to the display, for screens that don't need the full colour depth
+      void SetColorDepth(Drivers::St7789::ColorDepth depth);
+
+      Drivers::St7789::ColorDepth GetColorDepth() const {
+        return colorDepth;
+      }
+
       bool GetFullRefresh() {
         bool returnValue = fullRefresh;
         if (fullRefresh) {
@@ -41,18 +59,35 @@ namespace Pinetime {
       void InitDisplay();
       void InitTouchpad();
       void InitFileSystem();
+      size_t BufferSize(size_t nbPixels) const;
+      void ReleaseTransitionBuffers();
+      static void PackRgb444(uint8_t* data, size_t nbPixels);
 
       Pinetime::Drivers::St7789& lcd;
       Pinetime::Controllers::FS& filesystem;
 
+      static constexpr uint8_t nbWriteLines = 4;
       lv_disp_buf_t disp_buf_2;
-      lv_color_t buf2_1[LV_HOR_RES_MAX * 4];
-      lv_color_t buf2_2[LV_HOR_RES_MAX * 4];
+      lv_color_t buf2_1[LV_HOR_RES_MAX * nbWriteLines];
+      lv_color_t buf2_2[LV_HOR_RES_MAX * nbWriteLines];
+
+      // Larger draw buffers allocated on the heap for the duration of a screen transition
+      lv_color_t* transitionBuffer = nullptr;
+      static constexpr size_t minFreeHeapForTransitionBuffers = 4096;
+      TickType_t transitionStart = 0;
+      uint32_t transitionFlushCount = 0;
+      uint32_t transitionAddrWindowStart = 0;
 
       lv_disp_drv_t disp_drv;
+      lv_disp_t* disp = nullptr;
+      lv_indev_t* indev = nullptr;
+
+      static constexpr uint32_t idleRefreshPeriod = 1000;
+      // The release of a touch must be read at the normal period
+      static constexpr uint32_t activeDelay = 200;
+      bool idle = false;
 
       bool fullRefresh = false;
-      static constexpr uint8_t nbWriteLines = 4;
       static constexpr uint16_t totalNbLines = 320;
       static constexpr uint16_t visibleNbLines = 240;
 
@@ -60,6 +95,10 @@ namespace Pinetime {
         return LV_VER_RES_MAX - nbWriteLines;
       }
 
+      Drivers::St7789::ColorDepth colorDepth = Drivers::St7789::ColorDepth::Rgb565;
+      bool partialMode = false;
+      lv_area_t partialArea;
+
       FullRefreshDirections scrollDirection = FullRefreshDirections::None;
       uint16_t writeOffset = 0;
       uint16_t scrollOffset = 0;
@@ -25,6 +25,10 @@ namespace Pinetime {
         SmartAlarmTriggered,
         Chime,
         BleRadioEnableToggle,
+        // Controller data the current screen may display has changed
+        DataChanged,
+        // Files of the external resources were added or replaced
+        ResourcesChanged,
       };
     }
   }
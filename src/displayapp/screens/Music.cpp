@@ -18,6 +18,7 @@
 #include "displayapp/screens/Music.h"
 #include "displayapp/screens/Symbols.h"
 #include <cstdint>
+#include <cstring>
 #include "displayapp/DisplayApp.h"
 #include "components/ble/MusicService.h"
 #include "displayapp/icons/music/disc.c"
@@ -152,18 +153,16 @@ Music::~Music() {
 }
 
 void Music::Refresh() {
-  if (artist != musicService.getArtist()) {
-    artist = musicService.getArtist();
-    lv_label_set_text(txtArtist, artist.data());
-  }
-
-  if (track != musicService.getTrack()) {
-    track = musicService.getTrack();
-    lv_label_set_text(txtTrack, track.data());
-  }
-
-  if (album != musicService.getAlbum()) {
-    album = musicService.getAlbum();
+  Controllers::MusicService::TrackInfo latest;
+  latest.generation = trackInfo.generation;
+  if (musicService.getTrackInfo(latest)) {
+    if (std::strcmp(latest.artist.data(), trackInfo.artist.data()) != 0) {
+      lv_label_set_text(txtArtist, latest.artist.data());
+    }
+    if (std::strcmp(latest.track.data(), trackInfo.track.data()) != 0) {
+      lv_label_set_text(txtTrack, latest.track.data());
+    }
+    trackInfo = latest;
   }
 
   if (playing != musicService.isPlaying()) {
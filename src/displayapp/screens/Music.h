@@ -19,18 +19,14 @@
 
 #include <FreeRTOS.h>
 #include <lvgl/src/lv_core/lv_obj.h>
-#include <string>
 #include "displayapp/screens/Screen.h"
+#include "components/ble/MusicService.h"
 #include "displayapp/widgets/PageIndicator.h"
 #include "displayapp/apps/Apps.h"
 #include "displayapp/Controllers.h"
 #include "Symbols.h"
 
 namespace Pinetime {
-  namespace Controllers {
-    class MusicService;
-  }
-
   namespace Applications {
     namespace Screens {
       class Music : public Screen {
@@ -68,9 +64,7 @@ namespace Pinetime {
 
         Pinetime::Controllers::MusicService& musicService;
 
-        std::string artist;
-        std::string album;
-        std::string track;
+        Pinetime::Controllers::MusicService::TrackInfo trackInfo {};
 
         /** Total length in seconds */
         int totalLength = 0;
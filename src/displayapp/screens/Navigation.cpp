@@ -17,6 +17,8 @@
 */
 #include "displayapp/screens/Navigation.h"
 #include <cstdint>
+#include <cstring>
+#include <string_view>
 #include "displayapp/DisplayApp.h"
 #include "components/ble/NavigationService.h"
 #include "displayapp/InfiniTimeTheme.h"
@@ -34,36 +36,34 @@ using namespace Pinetime::Applications::Screens;
  *  - The array `iconMap` maps each icon with an index. This index corresponds to the position of
  *    the icon in the file. All index lower than 25 (`maxIconsPerFile`) represent icons located
  *    in the first file (navigation0.bin). All the other icons are located in the second file
- *    (navigation1.bin). Since all icons have the same height, this index must be multiplied by
- *    80px (`iconHeight`) to get the actual position (in pixels) of the icon in the image.
- * - This is how the images are laid out in the PNG files :
+ *    (navigation1.bin).
+ *  - The binary files are LVGL images in 1-bit indexed format: a 4 bytes header, a palette of 2 colours,
+ *    then 10 bytes per row of 80 pixels. All icons being 80 rows high, each one is an 800 bytes tile
+ *    that starts at header + palette + (index * 800) bytes in its file.
+ *  - Only the tile of the displayed icon is read into RAM (`iconBuffer`), and displayed from there.
+ *    Changing the icon costs a single 800 bytes read, redrawing it doesn't access the flash at all.
+ *  - This is how the icons are laid out in the files :
+ *  *---------------*
+ *  | HEADER        |
+ *  | PALETTE       |
  *  *---------------*
  *  | ICON 0        |
  *  | FILE 0        |
  *  | INDEX = 0     |
- *  | PIXEL# = 0    |
  *  *---------------*
  *  | ICON 1        |
  *  | FILE 0        |
  *  | INDEX = 1     |
- *  | PIXEL# = -80  |
- *  *---------------*
- *  | ICON 2        |
- *  | FILE 0        |
- *  | INDEX = 2     |
- *  | PIXEL# = -160 |
  *  *---------------*
  *  |     ...       |
  *  *---------------*
  *  | ICON 25       |
  *  | FILE 1        |
  *  | INDEX = 25    |
- *  | PIXEL# = 0    |
  *  *---------------*
  *  | ICON 26       |
  *  | FILE 1        |
  *  | INDEX = 26    |
- *  | PIXEL# = -80  |
  *  *---------------*
  *   - The source images are located in `src/resources/navigation0.png` and `src/resources/navigation1.png`
  */
@@ -71,14 +71,15 @@ using namespace Pinetime::Applications::Screens;
 namespace {
   struct Icon {
     const char* fileName;
-    int16_t offset;
+    uint32_t offset;
   };
 
-  constexpr uint16_t iconHeight = -80;
   constexpr uint8_t flagIndex = 18;
   constexpr uint8_t maxIconsPerFile = 25;
-  const char* iconsFile0 = "F:/images/navigation0.bin";
-  const char* iconsFile1 = "F:/images/navigation1.bin";
+  constexpr uint32_t headerSize = sizeof(lv_img_header_t);
+  constexpr uint32_t tileOffset = headerSize + Navigation::paletteSize;
+  const char* iconsFile0 = "/images/navigation0.bin";
+  const char* iconsFile1 = "/images/navigation1.bin";
 
   constexpr std::array<std::pair<const char*, uint8_t>, 86> iconMap = {{
     {"arrive-left", 1},
@@ -171,18 +172,18 @@ namespace {
 
   Icon GetIcon(uint8_t index) {
     if (index < maxIconsPerFile) {
-      return {iconsFile0, static_cast<int16_t>(iconHeight * index)};
+      return {iconsFile0, tileOffset + (index * Navigation::tileSize)};
     }
-    return {iconsFile1, static_cast<int16_t>(iconHeight * (index - maxIconsPerFile))};
+    return {iconsFile1, tileOffset + ((index - maxIconsPerFile) * Navigation::tileSize)};
   }
 
-  Icon GetIcon(std::string_view icon) {
+  uint8_t GetIconIndex(std::string_view icon) {
     for (const auto& iter : iconMap) {
       if (iter.first == icon) {
-        return GetIcon(iter.second);
+        return iter.second;
       }
     }
-    return GetIcon(flagIndex);
+    return flagIndex;
   }
 }
 
@@ -190,14 +191,17 @@ namespace {
  * Navigation watchapp
  *
  */
-Navigation::Navigation(Pinetime::Controllers::NavigationService& nav) : navService(nav) {
-  const auto& image = GetIcon("flag");
+Navigation::Navigation(Pinetime::Controllers::NavigationService& nav, Pinetime::Controllers::FS& filesystem)
+  : navService(nav), filesystem {filesystem} {
+  iconDescriptor.header.always_zero = 0;
+  iconDescriptor.header.cf = LV_IMG_CF_INDEXED_1BIT;
+  iconDescriptor.header.w = iconSize;
+  iconDescriptor.header.h = iconSize;
+  iconDescriptor.data_size = iconBuffer.size();
+  iconDescriptor.data = iconBuffer.data();
+
   imgFlag = lv_img_create(lv_scr_act(), nullptr);
-  lv_img_set_auto_size(imgFlag, false);
-  lv_obj_set_size(imgFlag, 80, 80);
-  lv_img_set_src(imgFlag, image.fileName);
-  lv_img_set_offset_x(imgFlag, 0);
-  lv_img_set_offset_y(imgFlag, image.offset);
+  LoadIcon(flagIndex);
   lv_obj_set_style_local_image_recolor_opa(imgFlag, LV_IMG_PART_MAIN, LV_STATE_DEFAULT, LV_OPA_COVER);
   lv_obj_set_style_local_image_recolor(imgFlag, LV_IMG_PART_MAIN, LV_STATE_DEFAULT, LV_COLOR_CYAN);
   lv_obj_align(imgFlag, nullptr, LV_ALIGN_CENTER, 0, -60);
@@ -238,23 +242,21 @@ Navigation::~Navigation() {
 }
 
 void Navigation::Refresh() {
-  if (flag != navService.getFlag()) {
-    flag = navService.getFlag();
-    const auto& image = GetIcon(flag);
-    lv_img_set_src(imgFlag, image.fileName);
-    lv_obj_set_style_local_image_recolor_opa(imgFlag, LV_IMG_PART_MAIN, LV_STATE_DEFAULT, LV_OPA_COVER);
-    lv_obj_set_style_local_image_recolor(imgFlag, LV_IMG_PART_MAIN, LV_STATE_DEFAULT, LV_COLOR_CYAN);
-    lv_img_set_offset_y(imgFlag, image.offset);
-  }
+  Controllers::NavigationService::Directions latest;
+  latest.generation = directions.generation;
+  if (navService.getDirections(latest)) {
+    if (std::strcmp(latest.flag.data(), directions.flag.data()) != 0) {
+      LoadIcon(GetIconIndex(latest.flag.data()));
+    }
 
-  if (narrative != navService.getNarrative()) {
-    narrative = navService.getNarrative();
-    lv_label_set_text(txtNarrative, narrative.data());
-  }
+    if (std::strcmp(latest.narrative.data(), directions.narrative.data()) != 0) {
+      lv_label_set_text(txtNarrative, latest.narrative.data());
+    }
 
-  if (manDist != navService.getManDist()) {
-    manDist = navService.getManDist();
-    lv_label_set_text(txtManDist, manDist.data());
+    if (std::strcmp(latest.manDist.data(), directions.manDist.data()) != 0) {
+      lv_label_set_text(txtManDist, latest.manDist.data());
+    }
+    directions = latest;
   }
 
   if (progress != navService.getProgress()) {
@@ -268,18 +270,45 @@ void Navigation::Refresh() {
   }
 }
 
-bool Navigation::IsAvailable(Pinetime::Controllers::FS& filesystem) {
-  lfs_file file = {};
+void Navigation::LoadIcon(uint8_t index) {
+  // Several flags share the same icon
+  if (index == iconIndex) {
+    return;
+  }
+  const auto icon = GetIcon(index);
+  bool ok = true;
+  // The palette is the same in both files
+  if (iconIndex == invalidIconIndex) {
+    ok = ReadIconData(icon.fileName, headerSize, iconBuffer.data(), paletteSize);
+  }
+  ok = ok && ReadIconData(icon.fileName, icon.offset, iconBuffer.data() + paletteSize, tileSize);
+  if (!ok) {
+    return;
+  }
+  iconIndex = index;
 
-  if (filesystem.FileOpen(&file, "/images/navigation0.bin", LFS_O_RDONLY) < 0) {
-    return false;
+  // The descriptor didn't change, only the data it points to
+  lv_img_cache_invalidate_src(&iconDescriptor);
+  lv_img_set_src(imgFlag, &iconDescriptor);
+  lv_obj_invalidate(imgFlag);
+}
+
+bool Navigation::ReadIconData(const char* fileName, uint32_t offset, uint8_t* buffer, uint32_t size) {
+  Pinetime::Controllers::AssetPartition::Asset asset;
+  if (filesystem.AssetOpen(fileName, asset)) {
+    return filesystem.AssetRead(asset, offset, buffer, size) == size;
   }
-  filesystem.FileClose(&file);
 
-  if (filesystem.FileOpen(&file, "/images/navigation1.bin", LFS_O_RDONLY) < 0) {
+  lfs_file file = {};
+  if (filesystem.FileOpen(&file, fileName, LFS_O_RDONLY) < 0) {
     return false;
   }
+  filesystem.FileSeek(&file, offset);
+  bool ok = filesystem.FileRead(&file, buffer, size) == static_cast<int>(size);
   filesystem.FileClose(&file);
+  return ok;
+}
 
-  return true;
+bool Navigation::IsAvailable(Pinetime::Controllers::FS& filesystem) {
+  return filesystem.AssetExists(iconsFile0) && filesystem.AssetExists(iconsFile1);
 }
@@ -19,8 +19,8 @@
 
 #include <FreeRTOS.h>
 #include <lvgl/src/lv_core/lv_obj.h>
-#include <string>
 #include "displayapp/screens/Screen.h"
+#include "components/ble/NavigationService.h"
 #include <array>
 #include "displayapp/apps/Apps.h"
 #include "displayapp/Controllers.h"
@@ -28,7 +28,6 @@
 
 namespace Pinetime {
   namespace Controllers {
-    class NavigationService;
     class FS;
   }
 
@@ -36,23 +35,35 @@ namespace Pinetime {
     namespace Screens {
       class Navigation : public Screen {
       public:
-        explicit Navigation(Pinetime::Controllers::NavigationService& nav);
+        Navigation(Pinetime::Controllers::NavigationService& nav, Pinetime::Controllers::FS& filesystem);
         ~Navigation() override;
 
         void Refresh() override;
         static bool IsAvailable(Pinetime::Controllers::FS& filesystem);
 
+        static constexpr uint8_t iconSize = 80;
+        static constexpr uint32_t paletteSize = 2 * sizeof(lv_color32_t);
+        static constexpr uint32_t tileSize = (iconSize / 8) * iconSize;
+
       private:
+        void LoadIcon(uint8_t index);
+        bool ReadIconData(const char* fileName, uint32_t offset, uint8_t* buffer, uint32_t size);
+
         lv_obj_t* imgFlag;
         lv_obj_t* txtNarrative;
         lv_obj_t* txtManDist;
         lv_obj_t* barProgress;
 
         Pinetime::Controllers::NavigationService& navService;
+        Pinetime::Controllers::FS& filesystem;
+
+        // Palette and pixels of the displayed icon, in LVGL 1-bit indexed format
+        std::array<uint8_t, paletteSize + tileSize> iconBuffer {};
+        lv_img_dsc_t iconDescriptor;
+        static constexpr uint8_t invalidIconIndex = 0xff;
+        uint8_t iconIndex = invalidIconIndex;
 
-        std::string flag;
-        std::string narrative;
-        std::string manDist;
+        Pinetime::Controllers::NavigationService::Directions directions {};
         int progress = 0;
 
         lv_task_t* taskRefresh;
@@ -65,7 +76,7 @@ namespace Pinetime {
       static constexpr const char* icon = Screens::Symbols::map;
 
       static Screens::Screen* Create(AppControllers& controllers) {
-        return new Screens::Navigation(*controllers.navigationService);
+        return new Screens::Navigation(*controllers.navigationService, controllers.filesystem);
       };
 
       static bool IsAvailable(Pinetime::Controllers::FS& filesystem) {
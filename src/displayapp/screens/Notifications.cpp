@@ -27,13 +27,7 @@ Notifications::Notifications(DisplayApp* app,
   auto notification = notificationManager.GetLastNotification();
   if (notification.valid) {
     currentId = notification.id;
-    currentItem = std::make_unique<NotificationItem>(notification.Title(),
-                                                     notification.Message(),
-                                                     1,
-                                                     notification.category,
-                                                     notificationManager.NbNotifications(),
-                                                     alertNotificationService,
-                                                     motorController);
+    currentItem = MakeItem(notification, 1);
     validDisplay = true;
   } else {
     currentItem = std::make_unique<NotificationItem>(alertNotificationService, motorController);
@@ -61,6 +55,19 @@ Notifications::Notifications(DisplayApp* app,
   taskRefresh = lv_task_create(RefreshTaskCallback, LV_DISP_DEF_REFR_PERIOD, LV_TASK_PRIO_MID, this);
 }
 
+std::unique_ptr<Notifications::NotificationItem>
+Notifications::MakeItem(const Controllers::NotificationManager::NotificationView& notification, uint8_t notifNr) {
+  Controllers::NotificationManager::NotificationText text;
+  notificationManager.CopyText(notification.id, text);
+  return std::make_unique<NotificationItem>(text.Title(),
+                                            text.Message(),
+                                            notifNr,
+                                            notification.category,
+                                            notificationManager.NbNotifications(),
+                                            alertNotificationService,
+                                            motorController);
+}
+
 Notifications::~Notifications() {
   lv_task_del(taskRefresh);
   // make sure we stop any vibrations before exiting
@@ -103,13 +110,7 @@ void Notifications::Refresh() {
 
     if (validDisplay) {
       Controllers::NotificationManager::Notification::Idx currentIdx = notificationManager.IndexOf(currentId);
-      currentItem = std::make_unique<NotificationItem>(notification.Title(),
-                                                       notification.Message(),
-                                                       currentIdx + 1,
-                                                       notification.category,
-                                                       notificationManager.NbNotifications(),
-                                                       alertNotificationService,
-                                                       motorController);
+      currentItem = MakeItem(notification, currentIdx + 1);
     } else {
       running = false;
     }
@@ -180,7 +181,7 @@ bool Notifications::OnTouchEvent(Pinetime::Applications::TouchEvents event) {
       }
       return false;
     case Pinetime::Applications::TouchEvents::SwipeDown: {
-      Controllers::NotificationManager::Notification previousNotification;
+      Controllers::NotificationManager::NotificationView previousNotification;
       if (validDisplay) {
         previousNotification = notificationManager.GetPrevious(currentId);
       } else {
@@ -196,17 +197,11 @@ bool Notifications::OnTouchEvent(Pinetime::Applications::TouchEvents event) {
       validDisplay = true;
       currentItem.reset(nullptr);
       app->SetFullRefresh(DisplayApp::FullRefreshDirections::Down);
-      currentItem = std::make_unique<NotificationItem>(previousNotification.Title(),
-                                                       previousNotification.Message(),
-                                                       currentIdx + 1,
-                                                       previousNotification.category,
-                                                       notificationManager.NbNotifications(),
-                                                       alertNotificationService,
-                                                       motorController);
+      currentItem = MakeItem(previousNotification, currentIdx + 1);
     }
       return true;
     case Pinetime::Applications::TouchEvents::SwipeUp: {
-      Controllers::NotificationManager::Notification nextNotification;
+      Controllers::NotificationManager::NotificationView nextNotification;
       if (validDisplay) {
         nextNotification = notificationManager.GetNext(currentId);
       } else {
@@ -223,13 +218,7 @@ bool Notifications::OnTouchEvent(Pinetime::Applications::TouchEvents event) {
       validDisplay = true;
       currentItem.reset(nullptr);
       app->SetFullRefresh(DisplayApp::FullRefreshDirections::Up);
-      currentItem = std::make_unique<NotificationItem>(nextNotification.Title(),
-                                                       nextNotification.Message(),
-                                                       currentIdx + 1,
-                                                       nextNotification.category,
-                                                       notificationManager.NbNotifications(),
-                                                       alertNotificationService,
-                                                       motorController);
+      currentItem = MakeItem(nextNotification, currentIdx + 1);
     }
       return true;
     default:
@@ -91,6 +91,10 @@ namespace Pinetime {
         bool dismissingNotification = false;
 
         lv_task_t* taskRefresh;
+
+        // Copies the text of the notification out of the notification manager to display it
+        std::unique_ptr<NotificationItem> MakeItem(const Controllers::NotificationManager::NotificationView& notification,
+                                                   uint8_t notifNr);
       };
     }
   }
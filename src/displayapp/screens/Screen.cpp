@@ -4,3 +4,8 @@ using namespace Pinetime::Applications::Screens;
 void Screen::RefreshTaskCallback(lv_task_t* task) {
   static_cast<Screen*>(task->user_data)->Refresh();
 }
+
+void Screen::ScheduleRefresh(lv_task_t* task, uint32_t ticks) {
+  lv_task_set_period(task, ticks);
+  lv_task_reset(task);
+}
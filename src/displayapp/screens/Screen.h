@@ -1,8 +1,10 @@
 #pragma once
 
 #include <cstdint>
+#include <optional>
 #include "displayapp/TouchEvents.h"
 #include <lvgl/lvgl.h>
+#include "utility/DataChangeNotifier.h"
 
 namespace Pinetime {
   namespace Applications {
@@ -40,8 +42,44 @@ namespace Pinetime {
           return false;
         }
 
+        /** @return the part of the screen that must stay visible in always on display mode,
+         * or nothing if the whole screen must be displayed */
+        virtual std::optional<lv_area_t> AlwaysOnArea() const {
+          return std::nullopt;
+        }
+
+        /** @return true if the screen looks the same with 12-bit colours, which makes display transfers 25% shorter */
+        virtual bool UseReducedColorDepth() const {
+          return false;
+        }
+
+        /** Called by DisplayApp when controller data changed, refreshes the screen if it subscribed to any of the sources */
+        void OnDataChanged(Utility::DataSources changes) {
+          if ((changes & subscriptions).any()) {
+            dataChanges = changes;
+            Refresh();
+            dataChanges.reset();
+          }
+        }
+
       protected:
+        void Subscribe(Utility::DataSource source) {
+          subscriptions.set(static_cast<size_t>(source));
+        }
+
+        // True if Refresh() is called because this source changed
+        bool HasChanged(Utility::DataSource source) const {
+          return dataChanges.test(static_cast<size_t>(source));
+        }
+
+        // Re-arms the refresh task so that it runs again in the given number of ticks from now
+        static void ScheduleRefresh(lv_task_t* task, uint32_t ticks);
+
         bool running = true;
+
+      private:
+        Utility::DataSources subscriptions;
+        Utility::DataSources dataChanges;
       };
     }
   }
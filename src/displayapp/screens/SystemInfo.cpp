@@ -9,8 +9,11 @@
 #include "BootloaderVersion.h"
 #include "components/battery/BatteryController.h"
 #include "components/ble/BleController.h"
+#include "components/ble/ConnectionParametersManager.h"
+#include "components/ble/NotificationScheduler.h"
 #include "components/brightness/BrightnessController.h"
 #include "components/datetime/DateTimeController.h"
+#include "components/fs/FS.h"
 #include "components/motion/MotionController.h"
 #include "drivers/Watchdog.h"
 #include "displayapp/InfiniTimeTheme.h"
@@ -29,6 +32,18 @@ namespace {
     }
     return "???";
   }
+
+  const char* ToString(Pinetime::Controllers::ConnectionParametersManager::Modes mode) {
+    switch (mode) {
+      case Pinetime::Controllers::ConnectionParametersManager::Modes::Idle:
+        return "Idle";
+      case Pinetime::Controllers::ConnectionParametersManager::Modes::Streaming:
+        return "Streaming";
+      case Pinetime::Controllers::ConnectionParametersManager::Modes::Transfer:
+        return "Transfer";
+    }
+    return "???";
+  }
 }
 
 SystemInfo::SystemInfo(Pinetime::Applications::DisplayApp* app,
@@ -39,7 +54,10 @@ SystemInfo::SystemInfo(Pinetime::Applications::DisplayApp* app,
                        const Pinetime::Drivers::Watchdog& watchdog,
                        Pinetime::Controllers::MotionController& motionController,
                        const Pinetime::Drivers::Cst816S& touchPanel,
-                       const Pinetime::Drivers::SpiNorFlash& spiNorFlash)
+                       const Pinetime::Drivers::SpiNorFlash& spiNorFlash,
+                       Pinetime::Controllers::FS& filesystem,
+                       const Pinetime::Controllers::ConnectionParametersManager& connectionParameters,
+                       const Pinetime::Controllers::NotificationScheduler& notificationScheduler)
   : dateTimeController {dateTimeController},
     batteryController {batteryController},
     brightnessController {brightnessController},
@@ -48,6 +66,9 @@ SystemInfo::SystemInfo(Pinetime::Applications::DisplayApp* app,
     motionController {motionController},
     touchPanel {touchPanel},
     spiNorFlash {spiNorFlash},
+    filesystem {filesystem},
+    connectionParameters {connectionParameters},
+    notificationScheduler {notificationScheduler},
     screens {app,
              0,
              {[this]() -> std::unique_ptr<Screen> {
@@ -64,6 +85,15 @@ SystemInfo::SystemInfo(Pinetime::Applications::DisplayApp* app,
               },
               [this]() -> std::unique_ptr<Screen> {
                 return CreateScreen5();
+              },
+              [this]() -> std::unique_ptr<Screen> {
+                return CreateScreen6();
+              },
+              [this]() -> std::unique_ptr<Screen> {
+                return CreateScreen7();
+              },
+              [this]() -> std::unique_ptr<Screen> {
+                return CreateScreen8();
               }},
              Screens::ScreenListModes::UpDown} {
 }
@@ -96,7 +126,7 @@ std::unique_ptr<Screen> SystemInfo::CreateScreen1() {
                         BootloaderVersion::VersionString());
   lv_label_set_align(label, LV_LABEL_ALIGN_CENTER);
   lv_obj_align(label, lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
-  return std::make_unique<Screens::Label>(0, 5, label);
+  return std::make_unique<Screens::Label>(0, 8, label);
 }
 
 std::unique_ptr<Screen> SystemInfo::CreateScreen2() {
@@ -175,7 +205,7 @@ std::unique_ptr<Screen> SystemInfo::CreateScreen2() {
                         touchPanel.GetFwVersion(),
                         TARGET_DEVICE_NAME);
   lv_obj_align(label, lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
-  return std::make_unique<Screens::Label>(1, 5, label);
+  return std::make_unique<Screens::Label>(1, 8, label);
 }
 
 extern int mallocFailedCount;
@@ -214,14 +244,102 @@ std::unique_ptr<Screen> SystemInfo::CreateScreen3() {
                         mallocFailedCount,
                         stackOverflowCount);
   lv_obj_align(label, lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
-  return std::make_unique<Screens::Label>(2, 5, label);
+  return std::make_unique<Screens::Label>(2, 8, label);
+}
+
+std::unique_ptr<Screen> SystemInfo::CreateScreen4() {
+  const auto& stats = filesystem.GetUsageStats();
+  const uint32_t blockCount = filesystem.getSize() / filesystem.getBlockSize();
+  const auto blocksUsed = filesystem.GetFSSize();
+
+  lv_obj_t* label = lv_label_create(lv_scr_act(), nullptr);
+  lv_label_set_recolor(label, true);
+  lv_label_set_text_fmt(label,
+                        "#808080 Filesystem#\n"
+                        " #808080 Blocks# %ld/%lu\n"
+                        " #808080 Free runs# %d\n"
+                        " #808080 Longest# %d\n"
+                        " #808080 Erases# %lu\n"
+                        " #808080 Programs# %lu\n"
+                        " #808080 Max lock# %lums\n"
+                        "#808080 Maintenance#\n"
+                        " #808080 Runs# %lu\n"
+                        " #808080 Duration# %lums",
+                        blocksUsed,
+                        blockCount,
+                        stats.freeExtents,
+                        stats.largestFreeExtent,
+                        stats.erases,
+                        stats.programs,
+                        stats.maxLockTime,
+                        stats.maintenanceRuns,
+                        stats.maintenanceTime);
+  lv_obj_align(label, lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
+  return std::make_unique<Screens::Label>(3, 8, label);
+}
+
+std::unique_ptr<Screen> SystemInfo::CreateScreen5() {
+  const auto stats = connectionParameters.GetStats();
+  const auto notificationStats = notificationScheduler.GetStats();
+  auto seconds = [](TickType_t ticks) {
+    return static_cast<unsigned long>(ticks / configTICK_RATE_HZ);
+  };
+
+  lv_obj_t* label = lv_label_create(lv_scr_act(), nullptr);
+  lv_label_set_recolor(label, true);
+  lv_label_set_text_fmt(label,
+                        "#808080 BLE connection#\n"
+                        " #808080 Mode# %s\n"
+                        " #808080 Interval# %lums\n"
+                        " #808080 Latency# %d\n"
+                        " #808080 Req./rej.# %lu/%lu\n"
+                        "#808080 Idle/stream/xfer#\n"
+                        " %lus/%lus/%lus\n"
+                        "#808080 Notifications#\n"
+                        " #808080 Sent# %lu\n"
+                        " #808080 Coal./drop.# %lu/%lu",
+                        ToString(stats.mode),
+                        stats.interval * 5UL / 4UL,
+                        stats.latency,
+                        stats.nbRequests,
+                        stats.nbRejected,
+                        seconds(stats.timeInMode[0]),
+                        seconds(stats.timeInMode[1]),
+                        seconds(stats.timeInMode[2]),
+                        notificationStats.sent,
+                        notificationStats.coalesced,
+                        notificationStats.dropped);
+  lv_obj_align(label, lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
+  return std::make_unique<Screens::Label>(4, 8, label);
+}
+
+std::unique_ptr<Screen> SystemInfo::CreateScreen6() {
+  const auto& cacheStats = filesystem.ReadCacheStats();
+
+  lv_obj_t* label = lv_label_create(lv_scr_act(), nullptr);
+  lv_label_set_recolor(label, true);
+  lv_label_set_text_fmt(label,
+                        "#808080 Flash read cache#\n"
+                        " #808080 Hits# %lu\n"
+                        " #808080 Misses# %lu\n"
+                        " #808080 Bypassed# %lu\n"
+                        " #808080 Flash reads# %lu\n"
+                        "#808080 SPI flash#\n"
+                        " #808080 Erase susp.# %lu",
+                        cacheStats.hits,
+                        cacheStats.misses,
+                        cacheStats.bypassed,
+                        cacheStats.flashReads,
+                        spiNorFlash.NbEraseSuspends());
+  lv_obj_align(label, lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
+  return std::make_unique<Screens::Label>(5, 8, label);
 }
 
 bool SystemInfo::sortById(const TaskStatus_t& lhs, const TaskStatus_t& rhs) {
   return lhs.xTaskNumber < rhs.xTaskNumber;
 }
 
-std::unique_ptr<Screen> SystemInfo::CreateScreen4() {
+std::unique_ptr<Screen> SystemInfo::CreateScreen7() {
   static constexpr uint8_t maxTaskCount = 9;
   TaskStatus_t tasksStatus[maxTaskCount];
 
@@ -280,10 +398,10 @@ std::unique_ptr<Screen> SystemInfo::CreateScreen4() {
     }
     lv_table_set_cell_value(infoTask, i + 1, 3, buffer);
   }
-  return std::make_unique<Screens::Label>(3, 5, infoTask);
+  return std::make_unique<Screens::Label>(6, 8, infoTask);
 }
 
-std::unique_ptr<Screen> SystemInfo::CreateScreen5() {
+std::unique_ptr<Screen> SystemInfo::CreateScreen8() {
   lv_obj_t* label = lv_label_create(lv_scr_act(), nullptr);
   lv_label_set_recolor(label, true);
   lv_label_set_text_static(label,
@@ -297,5 +415,5 @@ std::unique_ptr<Screen> SystemInfo::CreateScreen5() {
                            "#FFFF00 InfiniTime#");
   lv_label_set_align(label, LV_LABEL_ALIGN_CENTER);
   lv_obj_align(label, lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
-  return std::make_unique<Screens::Label>(4, 5, label);
+  return std::make_unique<Screens::Label>(7, 8, label);
 }
@@ -10,6 +10,9 @@ namespace Pinetime {
     class Battery;
     class BrightnessController;
     class Ble;
+    class FS;
+    class ConnectionParametersManager;
+    class NotificationScheduler;
   }
 
   namespace Drivers {
@@ -30,7 +33,10 @@ namespace Pinetime {
                             const Pinetime::Drivers::Watchdog& watchdog,
                             Pinetime::Controllers::MotionController& motionController,
                             const Pinetime::Drivers::Cst816S& touchPanel,
-                            const Pinetime::Drivers::SpiNorFlash& spiNorFlash);
+                            const Pinetime::Drivers::SpiNorFlash& spiNorFlash,
+                            Pinetime::Controllers::FS& filesystem,
+                            const Pinetime::Controllers::ConnectionParametersManager& connectionParameters,
+                            const Pinetime::Controllers::NotificationScheduler& notificationScheduler);
         ~SystemInfo() override;
         bool OnTouchEvent(TouchEvents event) override;
 
@@ -43,8 +49,11 @@ namespace Pinetime {
         Pinetime::Controllers::MotionController& motionController;
         const Pinetime::Drivers::Cst816S& touchPanel;
         const Pinetime::Drivers::SpiNorFlash& spiNorFlash;
+        Pinetime::Controllers::FS& filesystem;
+        const Pinetime::Controllers::ConnectionParametersManager& connectionParameters;
+        const Pinetime::Controllers::NotificationScheduler& notificationScheduler;
 
-        ScreenList<5> screens;
+        ScreenList<8> screens;
 
         static bool sortById(const TaskStatus_t& lhs, const TaskStatus_t& rhs);
 
@@ -53,6 +62,9 @@ namespace Pinetime {
         std::unique_ptr<Screen> CreateScreen3();
         std::unique_ptr<Screen> CreateScreen4();
         std::unique_ptr<Screen> CreateScreen5();
+        std::unique_ptr<Screen> CreateScreen6();
+        std::unique_ptr<Screen> CreateScreen7();
+        std::unique_ptr<Screen> CreateScreen8();
       };
     }
   }
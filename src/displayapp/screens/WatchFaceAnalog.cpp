@@ -157,6 +157,10 @@ WatchFaceAnalog::WatchFaceAnalog(Controllers::DateTime& dateTimeController,
   lv_style_set_line_rounded(&hour_line_style_trace, LV_STATE_DEFAULT, false);
   lv_obj_add_style(hour_body_trace, LV_LINE_PART_MAIN, &hour_line_style_trace);
 
+  Subscribe(Utility::DataSource::Battery);
+  Subscribe(Utility::DataSource::Ble);
+  Subscribe(Utility::DataSource::Notifications);
+  Subscribe(Utility::DataSource::Time);
   taskRefresh = lv_task_create(RefreshTaskCallback, LV_DISP_DEF_REFR_PERIOD, LV_TASK_PRIO_MID, this);
 
   Refresh();
@@ -264,4 +268,6 @@ void WatchFaceAnalog::Refresh() {
       lv_label_set_text_fmt(label_date_day, "%s\n%02i", dateTimeController.DayOfWeekShortToString(), dateTimeController.Day());
     }
   }
+
+  ScheduleRefresh(taskRefresh, dateTimeController.TicksUntilNextSecond());
 }
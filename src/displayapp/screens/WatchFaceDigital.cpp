@@ -86,6 +86,13 @@ WatchFaceDigital::WatchFaceDigital(Controllers::DateTime& dateTimeController,
   lv_label_set_text_static(stepIcon, Symbols::shoe);
   lv_obj_align(stepIcon, stepValue, LV_ALIGN_OUT_LEFT_MID, -5, 0);
 
+  Subscribe(Utility::DataSource::Battery);
+  Subscribe(Utility::DataSource::Ble);
+  Subscribe(Utility::DataSource::HeartRate);
+  Subscribe(Utility::DataSource::Motion);
+  Subscribe(Utility::DataSource::Notifications);
+  Subscribe(Utility::DataSource::Weather);
+  Subscribe(Utility::DataSource::Time);
   taskRefresh = lv_task_create(RefreshTaskCallback, LV_DISP_DEF_REFR_PERIOD, LV_TASK_PRIO_MID, this);
   Refresh();
 }
@@ -95,6 +102,16 @@ WatchFaceDigital::~WatchFaceDigital() {
   lv_obj_clean(lv_scr_act());
 }
 
+std::optional<lv_area_t> WatchFaceDigital::AlwaysOnArea() const {
+  // Only keep the time and date visible
+  lv_area_t area;
+  lv_obj_get_coords(label_time, &area);
+  lv_area_t dateArea;
+  lv_obj_get_coords(label_date, &dateArea);
+  _lv_area_join(&area, &area, &dateArea);
+  return area;
+}
+
 void WatchFaceDigital::Refresh() {
   statusIcons.Update();
 
@@ -104,6 +121,10 @@ void WatchFaceDigital::Refresh() {
   }
 
   currentDateTime = std::chrono::time_point_cast<std::chrono::minutes>(dateTimeController.CurrentDateTime());
+  if (HasChanged(Utility::DataSource::Time)) {
+    // The clock type may have changed without a change of the time
+    currentDateTime.Invalidate();
+  }
 
   if (currentDateTime.IsUpdated()) {
     uint8_t hour = dateTimeController.Hours();
@@ -191,4 +212,6 @@ void WatchFaceDigital::Refresh() {
     lv_obj_realign(temperature);
     lv_obj_realign(weatherIcon);
   }
+
+  ScheduleRefresh(taskRefresh, dateTimeController.TicksUntilNextMinute());
 }
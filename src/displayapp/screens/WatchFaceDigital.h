@@ -41,6 +41,8 @@ namespace Pinetime {
 
         void Refresh() override;
 
+        std::optional<lv_area_t> AlwaysOnArea() const override;
+
       private:
         uint8_t displayedHour = -1;
         uint8_t displayedMinute = -1;
@@ -1,6 +1,7 @@
 #include "displayapp/screens/WatchFaceInfineat.h"
 
 #include <lvgl/lvgl.h>
+#include <algorithm>
 #include <cstdio>
 #include "displayapp/screens/Symbols.h"
 #include "displayapp/screens/BleIcon.h"
@@ -8,6 +9,7 @@
 #include "components/battery/BatteryController.h"
 #include "components/ble/BleController.h"
 #include "components/ble/NotificationManager.h"
+#include "displayapp/FontCache.h"
 #include "components/motion/MotionController.h"
 
 using namespace Pinetime::Applications::Screens;
@@ -125,24 +127,17 @@ WatchFaceInfineat::WatchFaceInfineat(Controllers::DateTime& dateTimeController,
                                      Controllers::NotificationManager& notificationManager,
                                      Controllers::Settings& settingsController,
                                      Controllers::MotionController& motionController,
-                                     Controllers::FS& filesystem)
+                                     FontCache& fontCache)
   : currentDateTime {{}},
     dateTimeController {dateTimeController},
     batteryController {batteryController},
     bleController {bleController},
     notificationManager {notificationManager},
     settingsController {settingsController},
-    motionController {motionController} {
-  lfs_file f = {};
-  if (filesystem.FileOpen(&f, "/fonts/teko.bin", LFS_O_RDONLY) >= 0) {
-    filesystem.FileClose(&f);
-    font_teko = lv_font_load("F:/fonts/teko.bin");
-  }
-
-  if (filesystem.FileOpen(&f, "/fonts/bebas.bin", LFS_O_RDONLY) >= 0) {
-    filesystem.FileClose(&f);
-    font_bebas = lv_font_load("F:/fonts/bebas.bin");
-  }
+    motionController {motionController},
+    fontCache {fontCache} {
+  font_teko = fontCache.Get("/fonts/teko.bin");
+  font_bebas = fontCache.Get("/fonts/bebas.bin");
 
   // Side Cover
   static constexpr lv_point_t linePoints[nLines][2] = {{{30, 25}, {68, -8}},
@@ -167,7 +162,7 @@ WatchFaceInfineat::WatchFaceInfineat(Controllers::DateTime& dateTimeController,
   }
 
   logoPine = lv_img_create(lv_scr_act(), nullptr);
-  lv_img_set_src(logoPine, "F:/images/pine_small.bin");
+  lv_img_set_src(logoPine, "A:/images/pine_small.bin");
   lv_obj_set_pos(logoPine, 15, 106);
 
   lineBattery = lv_line_create(lv_scr_act(), nullptr);
@@ -296,6 +291,11 @@ WatchFaceInfineat::WatchFaceInfineat(Controllers::DateTime& dateTimeController,
   lv_label_set_text_static(labelBtnSettings, Symbols::settings);
   lv_obj_set_hidden(btnSettings, true);
 
+  Subscribe(Utility::DataSource::Battery);
+  Subscribe(Utility::DataSource::Ble);
+  Subscribe(Utility::DataSource::Motion);
+  Subscribe(Utility::DataSource::Notifications);
+  Subscribe(Utility::DataSource::Time);
   taskRefresh = lv_task_create(RefreshTaskCallback, LV_DISP_DEF_REFR_PERIOD, LV_TASK_PRIO_MID, this);
   Refresh();
 }
@@ -303,20 +303,18 @@ WatchFaceInfineat::WatchFaceInfineat(Controllers::DateTime& dateTimeController,
 WatchFaceInfineat::~WatchFaceInfineat() {
   lv_task_del(taskRefresh);
 
-  if (font_bebas != nullptr) {
-    lv_font_free(font_bebas);
-  }
-  if (font_teko != nullptr) {
-    lv_font_free(font_teko);
-  }
-
   lv_obj_clean(lv_scr_act());
+
+  fontCache.Release(font_bebas);
+  fontCache.Release(font_teko);
 }
 
 bool WatchFaceInfineat::OnTouchEvent(Pinetime::Applications::TouchEvents event) {
   if ((event == Pinetime::Applications::TouchEvents::LongTap) && lv_obj_get_hidden(btnSettings)) {
     lv_obj_set_hidden(btnSettings, false);
     savedTick = xTaskGetTickCount();
+    // Refresh now to start checking when the button must be hidden again
+    lv_task_ready(taskRefresh);
     return true;
   }
   // Prevent screen from sleeping when double tapping with settings on
@@ -398,6 +396,10 @@ void WatchFaceInfineat::Refresh() {
   }
 
   currentDateTime = std::chrono::time_point_cast<std::chrono::minutes>(dateTimeController.CurrentDateTime());
+  if (HasChanged(Utility::DataSource::Time)) {
+    // The clock type may have changed without a change of the time
+    currentDateTime.Invalidate();
+  }
   if (currentDateTime.IsUpdated()) {
     uint8_t hour = dateTimeController.Hours();
     uint8_t minute = dateTimeController.Minutes();
@@ -468,6 +470,17 @@ void WatchFaceInfineat::Refresh() {
       savedTick = 0;
     }
   }
+
+  TickType_t nextRefresh = dateTimeController.TicksUntilNextMinute();
+  if (batteryController.IsCharging()) {
+    // Keep the charging animation running
+    nextRefresh = std::min(nextRefresh, pdMS_TO_TICKS(150));
+  }
+  if (!lv_obj_get_hidden(btnSettings)) {
+    // Check regularly if the settings button must be hidden
+    nextRefresh = std::min(nextRefresh, pdMS_TO_TICKS(250));
+  }
+  ScheduleRefresh(taskRefresh, nextRefresh);
 }
 
 void WatchFaceInfineat::SetBatteryLevel(uint8_t batteryPercent) {
@@ -491,22 +504,7 @@ void WatchFaceInfineat::ToggleBatteryIndicatorColor(bool showSideCover) {
 }
 
 bool WatchFaceInfineat::IsAvailable(Pinetime::Controllers::FS& filesystem) {
-  lfs_file file = {};
-
-  if (filesystem.FileOpen(&file, "/fonts/teko.bin", LFS_O_RDONLY) < 0) {
-    return false;
-  }
-
-  filesystem.FileClose(&file);
-  if (filesystem.FileOpen(&file, "/fonts/bebas.bin", LFS_O_RDONLY) < 0) {
-    return false;
-  }
-
-  filesystem.FileClose(&file);
-  if (filesystem.FileOpen(&file, "/images/pine_small.bin", LFS_O_RDONLY) < 0) {
-    return false;
-  }
-
-  filesystem.FileClose(&file);
-  return true;
+  return filesystem.AssetExists("/fonts/teko.bin") &&
+         filesystem.AssetExists("/fonts/bebas.bin") &&
+         filesystem.AssetExists("/images/pine_small.bin");
 }
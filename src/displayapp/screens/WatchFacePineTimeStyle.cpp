@@ -394,6 +394,12 @@ WatchFacePineTimeStyle::WatchFacePineTimeStyle(Controllers::DateTime& dateTimeCo
   lv_label_set_text_static(lblSetOpts, Symbols::settings);
   lv_obj_set_hidden(btnSetOpts, true);
 
+  Subscribe(Utility::DataSource::Battery);
+  Subscribe(Utility::DataSource::Ble);
+  Subscribe(Utility::DataSource::Motion);
+  Subscribe(Utility::DataSource::Notifications);
+  Subscribe(Utility::DataSource::Weather);
+  Subscribe(Utility::DataSource::Time);
   taskRefresh = lv_task_create(RefreshTaskCallback, LV_DISP_DEF_REFR_PERIOD, LV_TASK_PRIO_MID, this);
   Refresh();
 }
@@ -564,6 +570,8 @@ void WatchFacePineTimeStyle::Refresh() {
       savedTick = 0;
     }
   }
+
+  ScheduleRefresh(taskRefresh, dateTimeController.TicksUntilNextSecond());
 }
 
 void WatchFacePineTimeStyle::UpdateSelected(lv_obj_t* object, lv_event_t event) {
@@ -163,6 +163,11 @@ WatchFacePrideFlag::WatchFacePrideFlag(Controllers::DateTime& dateTimeController
 
   UpdateScreen(settingsController.GetPrideFlag());
 
+  Subscribe(Utility::DataSource::Battery);
+  Subscribe(Utility::DataSource::Ble);
+  Subscribe(Utility::DataSource::Motion);
+  Subscribe(Utility::DataSource::Notifications);
+  Subscribe(Utility::DataSource::Time);
   taskRefresh = lv_task_create(RefreshTaskCallback, LV_DISP_DEF_REFR_PERIOD, LV_TASK_PRIO_MID, this);
   Refresh();
 }
@@ -262,6 +267,8 @@ void WatchFacePrideFlag::Refresh() {
   if (themeChanged) {
     themeChanged = false;
   }
+
+  ScheduleRefresh(taskRefresh, dateTimeController.TicksUntilNextSecond());
 }
 
 void WatchFacePrideFlag::UpdateSelected(lv_obj_t* object, lv_event_t event) {
@@ -282,6 +289,7 @@ void WatchFacePrideFlag::UpdateSelected(lv_obj_t* object, lv_event_t event) {
     settingsController.SetPrideFlag(valueFlag);
     if (flagChanged) {
       UpdateScreen(valueFlag);
+      lv_task_ready(taskRefresh);
     }
   }
 }
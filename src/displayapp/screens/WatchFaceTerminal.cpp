@@ -71,6 +71,13 @@ WatchFaceTerminal::WatchFaceTerminal(Controllers::DateTime& dateTimeController,
 
   lv_obj_align(container, nullptr, LV_ALIGN_IN_TOP_LEFT, 0, 7);
 
+  Subscribe(Utility::DataSource::Battery);
+  Subscribe(Utility::DataSource::Ble);
+  Subscribe(Utility::DataSource::HeartRate);
+  Subscribe(Utility::DataSource::Motion);
+  Subscribe(Utility::DataSource::Notifications);
+  Subscribe(Utility::DataSource::Weather);
+  Subscribe(Utility::DataSource::Time);
   taskRefresh = lv_task_create(RefreshTaskCallback, LV_DISP_DEF_REFR_PERIOD, LV_TASK_PRIO_MID, this);
   Refresh();
 }
@@ -80,6 +87,19 @@ WatchFaceTerminal::~WatchFaceTerminal() {
   lv_obj_clean(lv_scr_act());
 }
 
+std::optional<lv_area_t> WatchFaceTerminal::AlwaysOnArea() const {
+  // Only keep the time and date visible
+  lv_area_t area;
+  lv_obj_get_coords(labelPrompt1, &area);
+  lv_area_t timeArea;
+  lv_obj_get_coords(labelTime, &timeArea);
+  _lv_area_join(&area, &area, &timeArea);
+  lv_area_t dateArea;
+  lv_obj_get_coords(labelDate, &dateArea);
+  _lv_area_join(&area, &area, &dateArea);
+  return area;
+}
+
 void WatchFaceTerminal::Refresh() {
   notificationState = notificationManager.AreNewNotificationsAvailable();
   if (notificationState.IsUpdated()) {
@@ -186,4 +206,6 @@ void WatchFaceTerminal::Refresh() {
       }
     }
   }
+
+  ScheduleRefresh(taskRefresh, dateTimeController.TicksUntilNextSecond());
 }
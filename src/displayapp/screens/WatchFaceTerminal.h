@@ -37,6 +37,12 @@ namespace Pinetime {
 
         void Refresh() override;
 
+        std::optional<lv_area_t> AlwaysOnArea() const override;
+
+        bool UseReducedColorDepth() const override {
+          return true;
+        }
+
       private:
         Utility::DirtyValue<int> batteryPercentRemaining {};
         Utility::DirtyValue<bool> powerPresent {};
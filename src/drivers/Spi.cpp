@@ -26,6 +26,19 @@ bool Spi::WriteCmdAndBuffer(const uint8_t* cmd, size_t cmdSize, const uint8_t* d
   return spiMaster.WriteCmdAndBuffer(pinCsn, cmd, cmdSize, data, dataSize);
 }
 
+bool Spi::WriteCmdAndBuffer(
+  const uint8_t* preCmd, size_t preCmdSize, const uint8_t* cmd, size_t cmdSize, const uint8_t* data, size_t dataSize) {
+  return spiMaster.WriteCmdAndBuffer(pinCsn, preCmd, preCmdSize, cmd, cmdSize, data, dataSize);
+}
+
+void Spi::Sync() {
+  spiMaster.Sync();
+}
+
+uint32_t Spi::FrequencyHz() const {
+  return spiMaster.FrequencyHz();
+}
+
 bool Spi::Init() {
   nrf_gpio_cfg_output(pinCsn);
   nrf_gpio_pin_set(pinCsn);
@@ -18,6 +18,10 @@ namespace Pinetime {
       bool Write(const uint8_t* data, size_t size, const std::function<void()>& preTransactionHook);
       bool Read(uint8_t* cmd, size_t cmdSize, uint8_t* data, size_t dataSize);
       bool WriteCmdAndBuffer(const uint8_t* cmd, size_t cmdSize, const uint8_t* data, size_t dataSize);
+      bool WriteCmdAndBuffer(
+        const uint8_t* preCmd, size_t preCmdSize, const uint8_t* cmd, size_t cmdSize, const uint8_t* data, size_t dataSize);
+      void Sync();
+      uint32_t FrequencyHz() const;
       void Sleep();
       void Wakeup();
 
@@ -94,6 +94,14 @@ bool SpiMaster::Init() {
   return true;
 }
 
+uint32_t SpiMaster::FrequencyHz() const {
+  switch (params.Frequency) {
+    case Frequencies::Freq8Mhz:
+      return 8000000;
+  }
+  return 0;
+}
+
 void SpiMaster::SetupWorkaroundForErratum58() {
   nrfx_gpiote_pin_t pin = spiBaseAddress->PSEL.SCK;
   nrfx_gpiote_in_config_t gpioteCfg = {.sense = NRF_GPIOTE_POLARITY_TOGGLE,
@@ -142,7 +150,7 @@ void SpiMaster::OnEndEvent() {
 
   auto s = currentBufferSize;
   if (s > 0) {
-    auto currentSize = std::min((size_t) 255, s);
+    auto currentSize = std::min(maxTransferSize, s);
     PrepareTx(currentBufferAddr, currentSize);
     currentBufferAddr = currentBufferAddr + currentSize;
     currentBufferSize = currentBufferSize - currentSize;
@@ -202,7 +210,7 @@ bool SpiMaster::Write(uint8_t pinCsn, const uint8_t* data, size_t size, const st
   currentBufferAddr = (uint32_t) data;
   currentBufferSize = size;
 
-  auto currentSize = std::min((size_t) 255, (size_t) currentBufferSize);
+  auto currentSize = std::min(maxTransferSize, (size_t) currentBufferSize);
   PrepareTx(currentBufferAddr, currentSize);
   currentBufferSize = currentBufferSize - currentSize;
   currentBufferAddr = currentBufferAddr + currentSize;
@@ -222,6 +230,12 @@ bool SpiMaster::Write(uint8_t pinCsn, const uint8_t* data, size_t size, const st
   return true;
 }
 
+void SpiMaster::Sync() {
+  // The mutex is only released by OnEndEvent() when the last chunk has been sent
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  xSemaphoreGive(mutex);
+}
+
 bool SpiMaster::Read(uint8_t pinCsn, uint8_t* cmd, size_t cmdSize, uint8_t* data, size_t dataSize) {
   xSemaphoreTake(mutex, portMAX_DELAY);
 
@@ -241,11 +255,16 @@ bool SpiMaster::Read(uint8_t pinCsn, uint8_t* cmd, size_t cmdSize, uint8_t* data
   while (spiBaseAddress->EVENTS_END == 0)
     ;
 
-  PrepareRx((uint32_t) data, dataSize);
-  spiBaseAddress->TASKS_START = 1;
-
-  while (spiBaseAddress->EVENTS_END == 0)
-    ;
+  // Longer reads are split in several transfers, CS stays low in between
+  while (dataSize > 0) {
+    auto currentSize = std::min(maxTransferSize, dataSize);
+    PrepareRx((uint32_t) data, currentSize);
+    spiBaseAddress->TASKS_START = 1;
+    while (spiBaseAddress->EVENTS_END == 0)
+      ;
+    data += currentSize;
+    dataSize -= currentSize;
+  }
   nrf_gpio_pin_set(this->pinCsn);
 
   xSemaphoreGive(mutex);
@@ -270,6 +289,16 @@ void SpiMaster::Wakeup() {
 }
 
 bool SpiMaster::WriteCmdAndBuffer(uint8_t pinCsn, const uint8_t* cmd, size_t cmdSize, const uint8_t* data, size_t dataSize) {
+  return WriteCmdAndBuffer(pinCsn, nullptr, 0, cmd, cmdSize, data, dataSize);
+}
+
+bool SpiMaster::WriteCmdAndBuffer(uint8_t pinCsn,
+                                  const uint8_t* preCmd,
+                                  size_t preCmdSize,
+                                  const uint8_t* cmd,
+                                  size_t cmdSize,
+                                  const uint8_t* data,
+                                  size_t dataSize) {
   xSemaphoreTake(mutex, portMAX_DELAY);
 
   this->pinCsn = pinCsn;
@@ -278,21 +307,36 @@ bool SpiMaster::WriteCmdAndBuffer(uint8_t pinCsn, const uint8_t* cmd, size_t cmd
   spiBaseAddress->INTENCLR = (1 << 1);
   spiBaseAddress->INTENCLR = (1 << 19);
 
-  nrf_gpio_pin_clear(this->pinCsn);
-
   currentBufferAddr = 0;
   currentBufferSize = 0;
 
+  // The preceding command (the write enable of a flash memory for example) is sent in its own CS frame,
+  // without releasing the bus in between
+  if (preCmd != nullptr) {
+    nrf_gpio_pin_clear(this->pinCsn);
+    PrepareTx((uint32_t) preCmd, preCmdSize);
+    spiBaseAddress->TASKS_START = 1;
+    while (spiBaseAddress->EVENTS_END == 0)
+      ;
+    nrf_gpio_pin_set(this->pinCsn);
+  }
+
+  nrf_gpio_pin_clear(this->pinCsn);
+
   PrepareTx((uint32_t) cmd, cmdSize);
   spiBaseAddress->TASKS_START = 1;
   while (spiBaseAddress->EVENTS_END == 0)
     ;
 
-  PrepareTx((uint32_t) data, dataSize);
-  spiBaseAddress->TASKS_START = 1;
-
-  while (spiBaseAddress->EVENTS_END == 0)
-    ;
+  while (dataSize > 0) {
+    auto currentSize = std::min(maxTransferSize, dataSize);
+    PrepareTx((uint32_t) data, currentSize);
+    spiBaseAddress->TASKS_START = 1;
+    while (spiBaseAddress->EVENTS_END == 0)
+      ;
+    data += currentSize;
+    dataSize -= currentSize;
+  }
   nrf_gpio_pin_set(this->pinCsn);
 
   xSemaphoreGive(mutex);
@@ -16,6 +16,7 @@ namespace Pinetime {
       enum class SpiModule : uint8_t { SPI0, SPI1 };
       enum class BitOrder : uint8_t { Msb_Lsb, Lsb_Msb };
       enum class Modes : uint8_t { Mode0, Mode1, Mode2, Mode3 };
+      // 8 MHz is the highest frequency supported by SPIM0-2 on the nRF52832
       enum class Frequencies : uint8_t { Freq8Mhz };
 
       struct Parameters {
@@ -34,10 +35,21 @@ namespace Pinetime {
       SpiMaster& operator=(SpiMaster&&) = delete;
 
       bool Init();
+      uint32_t FrequencyHz() const;
       bool Write(uint8_t pinCsn, const uint8_t* data, size_t size, const std::function<void()>& preTransactionHook);
       bool Read(uint8_t pinCsn, uint8_t* cmd, size_t cmdSize, uint8_t* data, size_t dataSize);
 
       bool WriteCmdAndBuffer(uint8_t pinCsn, const uint8_t* cmd, size_t cmdSize, const uint8_t* data, size_t dataSize);
+      bool WriteCmdAndBuffer(uint8_t pinCsn,
+                             const uint8_t* preCmd,
+                             size_t preCmdSize,
+                             const uint8_t* cmd,
+                             size_t cmdSize,
+                             const uint8_t* data,
+                             size_t dataSize);
+
+      // Waits for the end of the ongoing transfer, after which the buffer it used can be reused
+      void Sync();
 
       void OnStartedEvent();
       void OnEndEvent();
@@ -51,6 +63,9 @@ namespace Pinetime {
       void PrepareTx(const volatile uint32_t bufferAddress, const volatile size_t size);
       void PrepareRx(const volatile uint32_t bufferAddress, const volatile size_t size);
 
+      // TXD.MAXCNT and RXD.MAXCNT are 8 bits wide on the nRF52832
+      static constexpr size_t maxTransferSize = 255;
+
       NRF_SPIM_Type* spiBaseAddress;
       uint8_t pinCsn;
 
@@ -3,10 +3,44 @@
 #include <libraries/delay/nrf_delay.h>
 #include <libraries/log/nrf_log.h>
 #include "drivers/Spi.h"
+#include "nrf_assert.h"
 
 using namespace Pinetime::Drivers;
 
+namespace {
+  struct KnownPart {
+    uint8_t manufacturer;
+    uint8_t type;
+    uint8_t density;
+    // Highest clock frequency supported by the Read (0x03) command
+    uint32_t maxReadFrequency;
+    // Supports the Suspend (0x75) and Resume (0x7A) commands during an erase
+    bool eraseSuspend;
+  };
+
+  constexpr KnownPart knownParts[] = {
+    {0x0B, 0x40, 0x16, 50000000, true}, // XTX XT25F32B
+    {0xC2, 0x20, 0x16, 50000000, true}, // Macronix MX25L3233F
+  };
+
+  // Conservative values for the parts that are not listed above
+  constexpr KnownPart unknownPart = {0, 0, 0, 20000000, false};
+
+  const KnownPart& FindPart(const SpiNorFlash::Identification& id) {
+    for (const auto& part : knownParts) {
+      if (part.manufacturer == id.manufacturer && part.type == id.type && part.density == id.density) {
+        return part;
+      }
+    }
+    return unknownPart;
+  }
+}
+
 SpiNorFlash::SpiNorFlash(Spi& spi) : spi {spi} {
+  mutex = xSemaphoreCreateMutex();
+  ASSERT(mutex != nullptr);
+  modifyMutex = xSemaphoreCreateMutex();
+  ASSERT(modifyMutex != nullptr);
 }
 
 void SpiNorFlash::Init() {
@@ -15,6 +49,13 @@ void SpiNorFlash::Init() {
                device_id.manufacturer,
                device_id.type,
                device_id.density);
+  const KnownPart& part = FindPart(device_id);
+  // Read (0x03) has no dummy byte, it is the fastest command as long as the part supports it at the SPI frequency
+  readMode = (spi.FrequencyHz() > part.maxReadFrequency) ? ReadModes::FastRead : ReadModes::Read;
+  eraseSuspendSupported = part.eraseSuspend;
+  NRF_LOG_INFO("[SpiNorFlash] Read mode : %s, erase suspend : %d",
+               (readMode == ReadModes::FastRead) ? "fast read" : "read",
+               eraseSuspendSupported);
 }
 
 void SpiNorFlash::Uninit() {
@@ -71,6 +112,42 @@ uint8_t SpiNorFlash::ReadConfigurationRegister() {
 }
 
 void SpiNorFlash::Read(uint32_t address, uint8_t* buffer, size_t size) {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+
+  // The chip cannot be read while it is busy: an erase is suspended if the part supports it, otherwise (and for
+  // page programs, which are short) the read waits for the end of the operation
+  bool suspended = false;
+  while (operation != Operations::None) {
+    if (operation == Operations::Erase && eraseSuspendSupported) {
+      SuspendErase();
+      suspended = true;
+      break;
+    }
+    xSemaphoreGive(mutex);
+    vTaskDelay(1);
+    xSemaphoreTake(mutex, portMAX_DELAY);
+  }
+
+  SendRead(address, buffer, size);
+
+  if (suspended) {
+    ResumeErase();
+  }
+  xSemaphoreGive(mutex);
+}
+
+void SpiNorFlash::SendRead(uint32_t address, uint8_t* buffer, size_t size) {
+  if (readMode == ReadModes::FastRead) {
+    static constexpr uint8_t fastReadCmdSize = 5;
+    uint8_t cmd[fastReadCmdSize] = {static_cast<uint8_t>(Commands::FastRead),
+                                    static_cast<uint8_t>(address >> 16U),
+                                    static_cast<uint8_t>(address >> 8U),
+                                    static_cast<uint8_t>(address),
+                                    0x00}; // dummy byte
+    spi.Read(reinterpret_cast<uint8_t*>(&cmd), fastReadCmdSize, buffer, size);
+    return;
+  }
+
   static constexpr uint8_t cmdSize = 4;
   uint8_t cmd[cmdSize] = {static_cast<uint8_t>(Commands::Read),
                           static_cast<uint8_t>(address >> 16U),
@@ -79,26 +156,93 @@ void SpiNorFlash::Read(uint32_t address, uint8_t* buffer, size_t size) {
   spi.Read(reinterpret_cast<uint8_t*>(&cmd), cmdSize, buffer, size);
 }
 
+void SpiNorFlash::SuspendErase() {
+  auto cmd = static_cast<uint8_t>(Commands::Suspend);
+  spi.Read(&cmd, sizeof(cmd), nullptr, 0);
+  // The erase is suspended within a few tens of microseconds (tSUS), WIP is cleared when the chip can be read
+  while (WriteInProgress()) {
+  }
+  nbEraseSuspends++;
+}
+
+void SpiNorFlash::ResumeErase() {
+  auto cmd = static_cast<uint8_t>(Commands::Resume);
+  spi.Read(&cmd, sizeof(cmd), nullptr, 0);
+  // Let the erase run for a while before it can be suspended again, so that back to back reads cannot starve it
+  nrf_delay_us(minEraseRunTimeUs);
+}
+
 void SpiNorFlash::WriteEnable() {
   auto cmd = static_cast<uint8_t>(Commands::WriteEnable);
   spi.Read(&cmd, sizeof(cmd), nullptr, 0);
 }
 
 void SpiNorFlash::SectorErase(uint32_t sectorAddress) {
+  Erase(Commands::SectorErase, sectorAddress);
+}
+
+void SpiNorFlash::BlockErase(uint32_t blockAddress) {
+  Erase(Commands::BlockErase, blockAddress);
+}
+
+void SpiNorFlash::Erase(Commands command, uint32_t address) {
   static constexpr uint8_t cmdSize = 4;
-  uint8_t cmd[cmdSize] = {static_cast<uint8_t>(Commands::SectorErase),
-                          static_cast<uint8_t>(sectorAddress >> 16U),
-                          static_cast<uint8_t>(sectorAddress >> 8U),
-                          static_cast<uint8_t>(sectorAddress)};
+  uint8_t cmd[cmdSize] = {static_cast<uint8_t>(command),
+                          static_cast<uint8_t>(address >> 16U),
+                          static_cast<uint8_t>(address >> 8U),
+                          static_cast<uint8_t>(address)};
 
+  xSemaphoreTake(modifyMutex, portMAX_DELAY);
+  xSemaphoreTake(mutex, portMAX_DELAY);
   WriteEnable();
   while (!WriteEnabled())
     vTaskDelay(1);
 
   spi.Read(reinterpret_cast<uint8_t*>(&cmd), cmdSize, nullptr, 0);
+  operation = Operations::Erase;
+  xSemaphoreGive(mutex);
+
+  // The mutex is released between the polls so that reads can suspend the erase
+  do {
+    vTaskDelay(1);
+  } while (!CheckCompletion());
+  xSemaphoreGive(modifyMutex);
+}
+
+bool SpiNorFlash::CheckCompletion() {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  bool done = !WriteInProgress();
+  if (done) {
+    operation = Operations::None;
+  }
+  xSemaphoreGive(mutex);
+  return done;
+}
 
-  while (WriteInProgress())
+// A page program takes about 0.5 ms, waiting for the next tick would double the time spent per page.
+// Poll for a short while first, then yield if the chip is slower than expected.
+void SpiNorFlash::WaitForProgram() {
+  for (uint32_t elapsed = 0; elapsed < programBusyPollUs; elapsed += programPollIntervalUs) {
+    nrf_delay_us(programPollIntervalUs);
+    if (CheckCompletion()) {
+      return;
+    }
+  }
+  programStats.nbYields++;
+  do {
     vTaskDelay(1);
+  } while (!CheckCompletion());
+}
+
+// Erases the 64 KB block starting at address if it is aligned on a block and the whole block is before end,
+// the sector containing address otherwise. Returns the number of bytes erased from address.
+size_t SpiNorFlash::EraseSpan(uint32_t address, uint32_t end) {
+  if ((address % blockSize) == 0 && end >= address + blockSize) {
+    BlockErase(address);
+    return blockSize;
+  }
+  SectorErase(address);
+  return sectorSize - (address % sectorSize);
 }
 
 uint8_t SpiNorFlash::ReadSecurityRegister() {
@@ -118,10 +262,13 @@ bool SpiNorFlash::EraseFailed() {
 
 void SpiNorFlash::Write(uint32_t address, const uint8_t* buffer, size_t size) {
   static constexpr uint8_t cmdSize = 4;
+  // Not static constexpr : EasyDMA can't read the constants in flash
+  uint8_t writeEnableCmd = static_cast<uint8_t>(Commands::WriteEnable);
 
   size_t len = size;
   uint32_t addr = address;
   const uint8_t* b = buffer;
+  xSemaphoreTake(modifyMutex, portMAX_DELAY);
   while (len > 0) {
     uint32_t pageLimit = (addr & ~(pageSize - 1u)) + pageSize;
     uint32_t toWrite = pageLimit - addr > len ? len : pageLimit - addr;
@@ -131,21 +278,38 @@ void SpiNorFlash::Write(uint32_t address, const uint8_t* buffer, size_t size) {
                             static_cast<uint8_t>(addr >> 8U),
                             static_cast<uint8_t>(addr)};
 
-    WriteEnable();
-    while (!WriteEnabled())
-      vTaskDelay(1);
+    // Write enable and page program are sent back to back, in a single acquisition of the bus
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    spi.WriteCmdAndBuffer(&writeEnableCmd, sizeof(writeEnableCmd), cmd, cmdSize, b, toWrite);
+    // The chip ignores the page program if the write enable latch was not set : neither WIP nor WEL are set then
+    if ((ReadStatusRegister() & 0x03u) == 0) {
+      NRF_LOG_INFO("[SpiNorFlash] Page program ignored, retrying");
+      WriteEnable();
+      while (!WriteEnabled())
+        vTaskDelay(1);
+      spi.WriteCmdAndBuffer(cmd, cmdSize, b, toWrite);
+    }
+    operation = Operations::Program;
+    xSemaphoreGive(mutex);
 
-    spi.WriteCmdAndBuffer(cmd, cmdSize, b, toWrite);
-
-    while (WriteInProgress())
-      vTaskDelay(1);
+    WaitForProgram();
+    programStats.nbPages++;
 
     addr += toWrite;
     b += toWrite;
     len -= toWrite;
   }
+  xSemaphoreGive(modifyMutex);
 }
 
 SpiNorFlash::Identification SpiNorFlash::GetIdentification() const {
   return device_id;
 }
+
+SpiNorFlash::ReadModes SpiNorFlash::GetReadMode() const {
+  return readMode;
+}
+
+SpiNorFlash::ProgramStats SpiNorFlash::GetProgramStats() const {
+  return programStats;
+}
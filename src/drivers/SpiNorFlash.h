@@ -1,6 +1,8 @@
 #pragma once
 #include <cstddef>
 #include <cstdint>
+#include <FreeRTOS.h>
+#include <semphr.h>
 
 namespace Pinetime {
   namespace Drivers {
@@ -20,6 +22,9 @@ namespace Pinetime {
         uint8_t density = 0;
       };
 
+      // Read needs a dummy byte after the address with FastRead, but can be clocked faster
+      enum class ReadModes : uint8_t { Read, FastRead };
+
       uint8_t ReadStatusRegister();
       bool WriteInProgress();
       bool WriteEnabled();
@@ -28,11 +33,29 @@ namespace Pinetime {
       void Write(uint32_t address, const uint8_t* buffer, size_t size);
       void WriteEnable();
       void SectorErase(uint32_t sectorAddress);
+      void BlockErase(uint32_t blockAddress);
+      size_t EraseSpan(uint32_t address, uint32_t end);
       uint8_t ReadSecurityRegister();
       bool ProgramFailed();
       bool EraseFailed();
 
       Identification GetIdentification() const;
+      ReadModes GetReadMode() const;
+
+      struct ProgramStats {
+        uint32_t nbPages;
+        // Pages that were not programmed within the busy poll window, after which the task yielded
+        uint32_t nbYields;
+      };
+      ProgramStats GetProgramStats() const;
+
+      uint32_t NbEraseSuspends() const {
+        return nbEraseSuspends;
+      }
+
+      static constexpr uint16_t pageSize = 256;
+      static constexpr uint32_t sectorSize = 0x1000;
+      static constexpr uint32_t blockSize = 0x10000;
 
       void Init();
       void Uninit();
@@ -42,23 +65,50 @@ namespace Pinetime {
 
     private:
       Identification ReadIdentification();
+      enum class Operations : uint8_t { None, Erase, Program };
 
       enum class Commands : uint8_t {
         PageProgram = 0x02,
         Read = 0x03,
+        FastRead = 0x0B,
         ReadStatusRegister = 0x05,
         WriteEnable = 0x06,
         ReadConfigurationRegister = 0x15,
         SectorErase = 0x20,
         ReadSecurityRegister = 0x2B,
+        Suspend = 0x75,
+        Resume = 0x7A,
         ReadIdentification = 0x9F,
         ReleaseFromDeepPowerDown = 0xAB,
-        DeepPowerDown = 0xB9
+        DeepPowerDown = 0xB9,
+        BlockErase = 0xD8
       };
-      static constexpr uint16_t pageSize = 256;
+
+      void SendRead(uint32_t address, uint8_t* buffer, size_t size);
+      void Erase(Commands command, uint32_t address);
+      bool CheckCompletion();
+      void WaitForProgram();
+      void SuspendErase();
+      void ResumeErase();
+
+      // Time an erase is left running after it has been resumed, before it can be suspended again
+      static constexpr uint32_t minEraseRunTimeUs = 100;
+      // Page programs are polled every programPollIntervalUs for up to programBusyPollUs before yielding
+      static constexpr uint32_t programPollIntervalUs = 50;
+      static constexpr uint32_t programBusyPollUs = 1000;
 
       Spi& spi;
       Identification device_id;
+      ReadModes readMode = ReadModes::Read;
+      bool eraseSuspendSupported = false;
+
+      // Protects the state of the chip: taken for each command, and released while an erase or a program is running
+      SemaphoreHandle_t mutex;
+      // Held for the whole duration of an erase or a program, the chip can only run one of them at a time
+      SemaphoreHandle_t modifyMutex;
+      Operations operation = Operations::None;
+      uint32_t nbEraseSuspends = 0;
+      ProgramStats programStats {};
     };
   }
 }
@@ -115,9 +115,24 @@ void St7789::SleepIn() {
 }
 
 void St7789::PixelFormat() {
+  continueWrite = false;
   WriteCommand(static_cast<uint8_t>(Commands::PixelFormat));
-  // 65K colours, 16-bit per pixel
-  WriteData(0x55);
+  if (colorDepth == ColorDepth::Rgb444) {
+    // 65K colours, 12-bit per pixel
+    WriteData(0x53);
+  } else {
+    // 65K colours, 16-bit per pixel
+    WriteData(0x55);
+  }
+}
+
+void St7789::SetColorDepth(ColorDepth depth) {
+  if (depth == colorDepth) {
+    return;
+  }
+  colorDepth = depth;
+  PixelFormat();
+  NRF_LOG_INFO("[LCD] %d-bit colour", (colorDepth == ColorDepth::Rgb444) ? 12 : 16);
 }
 
 void St7789::MemoryDataAccessControl() {
@@ -159,7 +174,7 @@ void St7789::PorchSet() {
     0x03, // Normal mode back porch
     0x01, // Porch control enable
     0xed, // Idle mode front:back porch
-    0xed, // Partial mode front:back porch (partial mode unused but set anyway)
+    0xed, // Partial mode front:back porch
   };
   WriteData(args, sizeof(args));
 }
@@ -178,7 +193,7 @@ void St7789::IdleFrameRateOn() {
   constexpr uint8_t args[] = {
     0x12, // Enable frame rate control for partial/idle mode, 4x frame divider
     0x1e, // Idle mode frame rate
-    0x1e, // Partial mode frame rate (unused)
+    0x1e, // Partial mode frame rate
   };
   WriteData(args, sizeof(args));
 }
@@ -188,7 +203,7 @@ void St7789::IdleFrameRateOff() {
   constexpr uint8_t args[] = {
     0x00, // Disable frame rate control and divider
     0x0a, // Idle mode frame rate (normal)
-    0x0a, // Partial mode frame rate (normal, unused)
+    0x0a, // Partial mode frame rate (normal)
   };
   WriteData(args, sizeof(args));
 }
@@ -268,8 +283,24 @@ void St7789::Uninit() {
 }
 
 void St7789::DrawBuffer(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint8_t* data, size_t size) {
-  SetAddrWindow(x, y, x + width - 1, y + height - 1);
-  WriteToRam(data, size);
+  if (continueWrite && x == windowStartColumn && (x + width - 1) == windowEndColumn && y == nextWriteLine) {
+    // These lines directly follow the ones written last, no need to set up a new address window
+    WriteCommand(static_cast<uint8_t>(Commands::WriteToRamContinue));
+    WriteData(data, size);
+  } else {
+    // The window extends to the bottom of the frame memory so that the next lines can be appended to it
+    SetAddrWindow(x, y, x + width - 1, Height - 1);
+    WriteToRam(data, size);
+    windowStartColumn = x;
+    windowEndColumn = x + width - 1;
+    addrWindowCount++;
+  }
+  nextWriteLine = y + height;
+  continueWrite = nextWriteLine < Height;
+}
+
+void St7789::SyncWrites() {
+  spi.Sync();
 }
 
 void St7789::HardwareReset() {
@@ -284,18 +315,42 @@ void St7789::HardwareReset() {
 }
 
 void St7789::LowPowerOn() {
+  continueWrite = false;
   IdleModeOn();
   IdleFrameRateOn();
   NRF_LOG_INFO("[LCD] Low power mode");
 }
 
 void St7789::LowPowerOff() {
+  continueWrite = false;
   IdleModeOff();
   IdleFrameRateOff();
   NRF_LOG_INFO("[LCD] Normal power mode");
 }
 
+void St7789::PartialModeOn(uint16_t startLine, uint16_t endLine) {
+  continueWrite = false;
+  WriteCommand(static_cast<uint8_t>(Commands::PartialArea));
+  uint8_t args[] = {
+    static_cast<uint8_t>(startLine >> 8), // Start line MSB
+    static_cast<uint8_t>(startLine),      // Start line LSB
+    static_cast<uint8_t>(endLine >> 8),   // End line MSB
+    static_cast<uint8_t>(endLine)         // End line LSB
+  };
+  memcpy(partialAreaArgs, args, sizeof(args));
+  WriteData(partialAreaArgs, sizeof(partialAreaArgs));
+  WriteCommand(static_cast<uint8_t>(Commands::PartialModeOn));
+  NRF_LOG_INFO("[LCD] Partial mode %d-%d", startLine, endLine);
+}
+
+void St7789::PartialModeOff() {
+  continueWrite = false;
+  NormalModeOn();
+  NRF_LOG_INFO("[LCD] Partial mode off");
+}
+
 void St7789::Sleep() {
+  continueWrite = false;
   SleepIn();
   nrf_gpio_cfg_default(pinDataCommand);
   NRF_LOG_INFO("[LCD] Sleep");
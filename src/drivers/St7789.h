@@ -11,6 +11,9 @@ namespace Pinetime {
 
     class St7789 {
     public:
+      // Interface pixel formats, the frame memory itself always stores 18-bit colours
+      enum class ColorDepth : uint8_t { Rgb565, Rgb444 };
+
       explicit St7789(Spi& spi, uint8_t pinDataCommand, uint8_t pinReset);
       St7789(const St7789&) = delete;
       St7789& operator=(const St7789&) = delete;
@@ -24,8 +27,22 @@ namespace Pinetime {
 
       void DrawBuffer(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint8_t* data, size_t size);
 
+      // Blocks until the data passed to the previous DrawBuffer() call has been sent
+      void SyncWrites();
+
+      // Number of address windows set up by DrawBuffer() since boot, each one costs 4 extra SPI transactions
+      uint32_t AddrWindowCount() const {
+        return addrWindowCount;
+      }
+
+      // In Rgb444 mode, DrawBuffer() expects 2 pixels packed in 3 bytes
+      void SetColorDepth(ColorDepth depth);
+
       void LowPowerOn();
       void LowPowerOff();
+      // Only drive the panel lines between startLine and endLine (inclusive), the rest of the panel is blanked
+      void PartialModeOn(uint16_t startLine, uint16_t endLine);
+      void PartialModeOff();
       void Sleep();
       void Wakeup();
 
@@ -35,6 +52,13 @@ namespace Pinetime {
       uint8_t pinReset;
       uint8_t verticalScrollingStartAddress = 0;
       bool sleepIn;
+      ColorDepth colorDepth = ColorDepth::Rgb565;
+
+      bool continueWrite = false;
+      uint16_t windowStartColumn = 0;
+      uint16_t windowEndColumn = 0;
+      uint16_t nextWriteLine = 0;
+      uint32_t addrWindowCount = 0;
       TickType_t lastSleepExit;
 
       void HardwareReset();
@@ -69,6 +93,7 @@ namespace Pinetime {
         SoftwareReset = 0x01,
         SleepIn = 0x10,
         SleepOut = 0x11,
+        PartialModeOn = 0x12,
         NormalModeOn = 0x13,
         DisplayInversionOn = 0x21,
         DisplayOff = 0x28,
@@ -76,6 +101,8 @@ namespace Pinetime {
         ColumnAddressSet = 0x2a,
         RowAddressSet = 0x2b,
         WriteToRam = 0x2c,
+        WriteToRamContinue = 0x3c,
+        PartialArea = 0x30,
         MemoryDataAccessControl = 0x36,
         VerticalScrollDefinition = 0x33,
         VerticalScrollStartAddress = 0x37,
@@ -99,6 +126,7 @@ namespace Pinetime {
 
       uint8_t addrWindowArgs[4];
       uint8_t verticalScrollArgs[2];
+      uint8_t partialAreaArgs[4];
     };
   }
 }
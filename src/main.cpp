@@ -39,6 +39,7 @@
 #include "components/alarm/SmartAlarmController.h"
 #include "components/stopwatch/StopWatchController.h"
 #include "components/fs/FS.h"
+#include "storagetask/StorageTask.h"
 #include "drivers/Spi.h"
 #include "drivers/SpiMaster.h"
 #include "drivers/SpiNorFlash.h"
@@ -97,6 +98,7 @@ Pinetime::Controllers::Battery batteryController;
 Pinetime::Controllers::Ble bleController;
 
 Pinetime::Controllers::FS fs {spiNorFlash};
+Pinetime::System::StorageTask storageTask {fs};
 Pinetime::Controllers::Settings settingsController {fs};
 Pinetime::Controllers::MotorController motorController {};
 
@@ -109,7 +111,7 @@ Pinetime::Controllers::NotificationManager notificationManager;
 Pinetime::Controllers::MotionController motionController;
 Pinetime::Controllers::StopWatchController stopWatchController;
 Pinetime::Controllers::AlarmController alarmController {dateTimeController, fs};
-Pinetime::Controllers::HeartRateLogger heartRateLogger {fs, dateTimeController};
+Pinetime::Controllers::HeartRateLogger heartRateLogger {storageTask, dateTimeController};
 Pinetime::Controllers::SmartAlarmController smartAlarmController {dateTimeController, fs, heartRateLogger, settingsController};
 Pinetime::Controllers::TouchHandler touchHandler;
 Pinetime::Controllers::ButtonHandler buttonHandler;
@@ -157,7 +159,8 @@ Pinetime::System::SystemTask systemTask(spi,
                                         fs,
                                         touchHandler,
                                         buttonHandler,
-                                        heartRateLogger);
+                                        heartRateLogger,
+                                        storageTask);
 int mallocFailedCount = 0;
 int stackOverflowCount = 0;
 extern "C" {
@@ -368,6 +371,7 @@ int main() {
     NoInit_MagicWord = NoInit_MagicValue;
   }
 
+  storageTask.Start();
   systemTask.Start();
 
   nimble_port_init();
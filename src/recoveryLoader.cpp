@@ -94,22 +94,33 @@ void Process(void* /*instance*/) {
   NRF_LOG_INFO("Display logo")
   DisplayLogo();
 
-  NRF_LOG_INFO("Erasing...");
-  for (uint32_t erased = 0; erased < sizeof(recoveryImage); erased += 0x1000) {
-    spiNorFlash.SectorErase(erased);
-    RefreshWatchdog();
-  }
-
   NRF_LOG_INFO("Writing factory image...");
-  static constexpr uint32_t memoryChunkSize = 200;
+  // Whole pages, so that each chunk is written with a single page program
+  static constexpr uint32_t memoryChunkSize = Pinetime::Drivers::SpiNorFlash::pageSize;
   uint8_t writeBuffer[memoryChunkSize];
+  uint32_t erased = 0;
+  TickType_t startTicks = xTaskGetTickCount();
   for (size_t offset = 0; offset < sizeof(recoveryImage); offset += memoryChunkSize) {
-    std::memcpy(writeBuffer, &recoveryImage[offset], memoryChunkSize);
-    spiNorFlash.Write(offset, writeBuffer, memoryChunkSize);
+    size_t chunkSize = std::min<size_t>(memoryChunkSize, sizeof(recoveryImage) - offset);
+    // Erase just ahead of the data, with 64 KB block erases where possible
+    while (erased < offset + chunkSize) {
+      erased += spiNorFlash.EraseSpan(erased, sizeof(recoveryImage));
+      RefreshWatchdog();
+    }
+    std::memcpy(writeBuffer, &recoveryImage[offset], chunkSize);
+    spiNorFlash.Write(offset, writeBuffer, chunkSize);
     DisplayProgressBar((static_cast<float>(offset) / static_cast<float>(sizeof(recoveryImage))) * 100.0f, colorWhite);
     RefreshWatchdog();
   }
-  NRF_LOG_INFO("Writing factory image done!");
+  uint32_t elapsedMs = (xTaskGetTickCount() - startTicks) * 1000 / configTICK_RATE_HZ;
+  uint32_t bytesPerSecond = (elapsedMs > 0) ? (uint64_t) sizeof(recoveryImage) * 1000 / elapsedMs : 0;
+  auto programStats = spiNorFlash.GetProgramStats();
+  NRF_LOG_INFO("Writing factory image done! %d bytes in %d ms (%d B/s), %d pages, %d yields",
+               sizeof(recoveryImage),
+               elapsedMs,
+               bytesPerSecond,
+               programStats.nbPages,
+               programStats.nbYields);
   DisplayProgressBar(100.0f, colorGreen);
 
   while (1) {
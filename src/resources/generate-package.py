@@ -3,13 +3,99 @@
 import io
 import sys
 import json
+import zlib
 import shutil
+import struct
 import typing
 import os.path
 import argparse
 import subprocess
 from zipfile import ZipFile
 
+# Flat asset image installed in the asset partition of the watch, see src/components/fs/AssetPartition.h
+ASSET_IMAGE_NAME = 'assets.bin'
+ASSET_IMAGE_PATH = '/' + ASSET_IMAGE_NAME
+ASSET_MAGIC = 0x53415450  # "PTAS"
+ASSET_VERSION = 2
+ASSET_MAX_BUCKETS = 32
+ASSET_ALIGNMENT = 256  # flash page
+ASSET_MAX_NAME_LENGTH = 64
+ASSET_PARTITION_SIZE = 0x40000
+
+# Resource manifest loaded by the watch at boot, see FS::VerifyResource()
+MANIFEST_NAME = 'resources.idx'
+MANIFEST_PATH = '/' + MANIFEST_NAME
+MANIFEST_MAGIC = 0x49525450  # "PTRI"
+MANIFEST_VERSION = 1
+MANIFEST_MAX_PATH_LENGTH = 64
+
+def build_manifest(assets):
+    """assets: list of (path on the watch, content). Return the manifest: path, size and CRC32 of each resource"""
+    manifest = struct.pack('<IHH', MANIFEST_MAGIC, MANIFEST_VERSION, len(assets))
+    for path, content in assets:
+        encoded_path = path.encode('utf-8')
+        if len(encoded_path) > MANIFEST_MAX_PATH_LENGTH:
+            sys.exit(f'Error: the path {path} is longer than {MANIFEST_MAX_PATH_LENGTH} characters.')
+        manifest += struct.pack('<IIB', len(content), zlib.crc32(content), len(encoded_path)) + encoded_path
+    return manifest
+
+def fnv1a(text):
+    h = 0x811C9DC5
+    for byte in text.encode('utf-8'):
+        h = ((h ^ byte) * 0x01000193) & 0xFFFFFFFF
+    return h
+
+def align(value):
+    return (value + ASSET_ALIGNMENT - 1) // ASSET_ALIGNMENT * ASSET_ALIGNMENT
+
+def build_asset_image(assets):
+    """assets: list of (path on the watch, content). Return the image: header, hash table, paths, aligned contents"""
+    nb_buckets = 1
+    while nb_buckets < 2 * len(assets):
+        nb_buckets *= 2
+    if nb_buckets > ASSET_MAX_BUCKETS:
+        sys.exit(f'Error: {len(assets)} assets do not fit in the {ASSET_MAX_BUCKETS} entries of the asset image.')
+
+    header_size = struct.calcsize('<IHHII')
+    bucket_format = '<IIIHBB'
+    names_offset = header_size + nb_buckets * struct.calcsize(bucket_format)
+    names = bytearray()
+    for path, _ in assets:
+        encoded_path = path.encode('utf-8')
+        if len(encoded_path) > ASSET_MAX_NAME_LENGTH:
+            sys.exit(f'Error: the path {path} is longer than {ASSET_MAX_NAME_LENGTH} characters.')
+        names += encoded_path
+    if names_offset + len(names) > 0xFFFF:
+        sys.exit('Error: the paths of the assets do not fit in the asset image.')
+
+    buckets = [(0, 0, 0, 0, 0, 0)] * nb_buckets
+    data = bytearray()
+    offset = align(names_offset + len(names))
+    name_offset = names_offset
+    for path, content in assets:
+        h = fnv1a(path)
+        if h == 0:
+            sys.exit(f'Error: the hash of {path} is 0, rename it.')
+        # The watch compares the paths, assets with the same hash are probed like the other collisions
+        index = h % nb_buckets
+        while buckets[index][0] != 0:
+            index = (index + 1) % nb_buckets
+        name_length = len(path.encode('utf-8'))
+        buckets[index] = (h, offset + len(data), len(content), name_offset, name_length, 0)
+        name_offset += name_length
+        data += content
+        data += bytes(align(len(data)) - len(data))
+
+    body = b''.join(struct.pack(bucket_format, *bucket) for bucket in buckets)
+    body += names
+    body += bytes(offset - header_size - len(body))
+    body += data
+    image_size = header_size + len(body)
+    if image_size > ASSET_PARTITION_SIZE:
+        sys.exit(f'Error: the asset image ({image_size} bytes) does not fit in the asset partition.')
+    header = struct.pack('<IHHII', ASSET_MAGIC, ASSET_VERSION, nb_buckets, image_size, zlib.crc32(body))
+    return header + body
+
 def main():
     ap = argparse.ArgumentParser(description='auto generate LVGL font files from fonts')
     ap.add_argument('--config', '-c', type=str, action='append', help='config file to use')
@@ -32,6 +118,7 @@ def main():
 
     zf = ZipFile(args.output, mode='w')
     resource_files = []
+    assets = []
 
     for config_file in args.config:
         with open(config_file, 'r') as fd:
@@ -40,15 +127,30 @@ def main():
         resource_names = set(data.keys())
         for name in resource_names:
             resource = data[name]
-            resource_files.append({
-                "filename": name+'.bin',
-                "path": resource['target_path'] + name+'.bin'
-            })
-
             path = name + '.bin'
             if not os.path.exists(path):
                 path = os.path.join(os.path.dirname(sys.argv[0]), path)
-            zf.write(path)
+            with open(path, 'rb') as fd:
+                assets.append((resource['target_path'] + name + '.bin', fd.read()))
+
+    # The resources are only uploaded in the asset image : the watches whose filesystem covers the asset partition
+    # extract it into individual files, see FS::InstallAssets()
+    with open(ASSET_IMAGE_NAME, 'wb') as fd:
+        fd.write(build_asset_image(sorted(assets)))
+    zf.write(ASSET_IMAGE_NAME)
+    resource_files.append({
+        "filename": ASSET_IMAGE_NAME,
+        "path": ASSET_IMAGE_PATH
+    })
+
+    # Uploaded last, once all the resources it lists are on the watch
+    with open(MANIFEST_NAME, 'wb') as fd:
+        fd.write(build_manifest(sorted(assets)))
+    zf.write(MANIFEST_NAME)
+    resource_files.append({
+        "filename": MANIFEST_NAME,
+        "path": MANIFEST_PATH
+    })
 
     if args.obsolete:
         obsolete_file_path = os.path.join(os.path.dirname(sys.argv[0]), args.obsolete)
@@ -7182,7 +7182,7 @@
 // <q> CRC32_ENABLED  - crc32 - CRC32 calculation routines
 
 #ifndef CRC32_ENABLED
-  #define CRC32_ENABLED 0
+  #define CRC32_ENABLED 1
 #endif
 
 // <q> ECC_ENABLED  - ecc - Elliptic Curve Cryptography Library
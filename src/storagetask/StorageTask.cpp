@@ -0,0 +1,216 @@
+#include "storagetask/StorageTask.h"
+#include <cstring>
+#include <libraries/log/nrf_log.h>
+#include <libraries/util/app_error.h>
+#include "components/fs/FS.h"
+#include "nrf_assert.h"
+
+using namespace Pinetime::System;
+
+StorageTask::StorageTask(Controllers::FS& fs) : fs {fs} {
+  blockingMutex = xSemaphoreCreateMutex();
+  ASSERT(blockingMutex != nullptr);
+  blockingDone = xSemaphoreCreateBinary();
+  ASSERT(blockingDone != nullptr);
+}
+
+void StorageTask::Start() {
+  requestQueue = xQueueCreate(queueSize, sizeof(Request));
+
+  // Same priority as the timer task and SystemTask, which wait for blocking requests: at a lower priority, the
+  // display task would delay them for as long as it is busy drawing
+  if (pdPASS != xTaskCreate(StorageTask::Process, "Storage", 350, this, 1, &taskHandle)) {
+    APP_ERROR_HANDLER(NRF_ERROR_NO_MEM);
+  }
+}
+
+void StorageTask::Process(void* instance) {
+  auto* app = static_cast<StorageTask*>(instance);
+  app->Work();
+}
+
+void StorageTask::Work() {
+  Request request;
+  while (true) {
+    // Keep the file open while writes are queued back to back, close it as soon as the queue is empty
+    TickType_t timeout = (openPath != nullptr) ? 0 : portMAX_DELAY;
+    if (xQueueReceive(requestQueue, &request, timeout) != pdTRUE) {
+      CloseFile();
+      continue;
+    }
+
+    int result = Execute(request);
+    if (result < 0) {
+      NRF_LOG_INFO("[Storage] request %d on %s failed : %d", static_cast<int>(request.operation), request.path, result);
+    }
+    if (request.callback != nullptr) {
+      request.callback(request.context, result);
+    }
+  }
+}
+
+int StorageTask::Execute(const Request& request) {
+  switch (request.operation) {
+    case Operations::Write: {
+      int res = OpenForWriting(request.path);
+      if (res < 0) {
+        return res;
+      }
+      res = fs.FileSeek(&file, request.offset);
+      if (res < 0) {
+        return res;
+      }
+      return fs.FileWrite(&file, request.data.data(), request.size);
+    }
+    case Operations::Append: {
+      int res = OpenForWriting(request.path);
+      if (res < 0) {
+        return res;
+      }
+      lfs_soff_t end = fs.FileSize(&file);
+      if (end < 0) {
+        return end;
+      }
+      res = fs.FileSeek(&file, end);
+      if (res < 0) {
+        return res;
+      }
+      return fs.FileWrite(&file, request.data.data(), request.size);
+    }
+    case Operations::Read: {
+      // Writes to the same file must be visible to the read
+      CloseFile();
+      lfs_file_t readFile;
+      int res = fs.FileOpen(&readFile, request.path, LFS_O_RDONLY);
+      if (res < 0) {
+        return res;
+      }
+      res = fs.FileSeek(&readFile, request.offset);
+      if (res >= 0) {
+        res = fs.FileRead(&readFile, static_cast<uint8_t*>(request.buffer), request.size);
+      }
+      fs.FileClose(&readFile);
+      return res;
+    }
+    case Operations::Stat:
+      CloseFile();
+      return fs.Stat(request.path, static_cast<lfs_info*>(request.buffer));
+    case Operations::Delete:
+      CloseFile();
+      return fs.FileDelete(request.path);
+    case Operations::CreateDir: {
+      CloseFile();
+      int res = fs.DirCreate(request.path);
+      return (res == LFS_ERR_EXIST) ? 0 : res;
+    }
+    case Operations::Flush:
+      CloseFile();
+      return 0;
+    case Operations::Maintenance:
+      CloseFile();
+      return fs.Maintenance();
+  }
+  return LFS_ERR_INVAL;
+}
+
+int StorageTask::OpenForWriting(const char* path) {
+  if (openPath != nullptr && std::strcmp(openPath, path) == 0) {
+    return 0;
+  }
+  CloseFile();
+  int res = fs.FileOpen(&file, path, LFS_O_RDWR | LFS_O_CREAT);
+  if (res == LFS_ERR_OK) {
+    openPath = path;
+  }
+  return res;
+}
+
+void StorageTask::CloseFile() {
+  if (openPath == nullptr) {
+    return;
+  }
+  int res = fs.FileClose(&file);
+  if (res < 0) {
+    NRF_LOG_INFO("[Storage] close %s failed : %d", openPath, res);
+  }
+  openPath = nullptr;
+}
+
+bool StorageTask::Push(const Request& request, TickType_t timeout) {
+  if (requestQueue == nullptr) {
+    return false;
+  }
+  if (xQueueSend(requestQueue, &request, timeout) != pdPASS) {
+    NRF_LOG_INFO("[Storage] queue full, request on %s dropped", request.path);
+    return false;
+  }
+  return true;
+}
+
+bool StorageTask::Write(const char* path, uint32_t offset, const void* data, size_t size, Callback callback, void* context) {
+  ASSERT(size <= maxDataSize);
+  Request request {Operations::Write, static_cast<uint16_t>(size), path, offset, nullptr, callback, context, {}};
+  std::memcpy(request.data.data(), data, size);
+  return Push(request, queueTimeout);
+}
+
+bool StorageTask::Append(const char* path, const void* data, size_t size, Callback callback, void* context) {
+  ASSERT(size <= maxDataSize);
+  Request request {Operations::Append, static_cast<uint16_t>(size), path, 0, nullptr, callback, context, {}};
+  std::memcpy(request.data.data(), data, size);
+  return Push(request, queueTimeout);
+}
+
+bool StorageTask::Delete(const char* path, Callback callback, void* context) {
+  return Push({Operations::Delete, 0, path, 0, nullptr, callback, context, {}}, queueTimeout);
+}
+
+bool StorageTask::CreateDir(const char* path, Callback callback, void* context) {
+  return Push({Operations::CreateDir, 0, path, 0, nullptr, callback, context, {}}, queueTimeout);
+}
+
+bool StorageTask::Read(const char* path, uint32_t offset, void* buffer, size_t size, Callback callback, void* context) {
+  return Push({Operations::Read, static_cast<uint16_t>(size), path, offset, buffer, callback, context, {}}, queueTimeout);
+}
+
+int StorageTask::ReadBlocking(const char* path, uint32_t offset, void* buffer, size_t size) {
+  Request request {Operations::Read, static_cast<uint16_t>(size), path, offset, buffer, nullptr, nullptr, {}};
+  return Blocking(request);
+}
+
+int StorageTask::StatBlocking(const char* path, lfs_info* info) {
+  Request request {Operations::Stat, 0, path, 0, info, nullptr, nullptr, {}};
+  return Blocking(request);
+}
+
+void StorageTask::Flush() {
+  Request request {Operations::Flush, 0, "", 0, nullptr, nullptr, nullptr, {}};
+  Blocking(request);
+}
+
+bool StorageTask::Maintenance(Callback callback, void* context) {
+  return Push({Operations::Maintenance, 0, "", 0, nullptr, callback, context, {}}, queueTimeout);
+}
+
+int StorageTask::Blocking(Request& request) {
+  // The storage task would wait for itself
+  ASSERT(xTaskGetCurrentTaskHandle() != taskHandle);
+
+  // Only one blocking request at a time, they share the completion semaphore
+  xSemaphoreTake(blockingMutex, portMAX_DELAY);
+  request.callback = OnBlockingDone;
+  request.context = this;
+  int result = LFS_ERR_IO;
+  if (Push(request, portMAX_DELAY)) {
+    xSemaphoreTake(blockingDone, portMAX_DELAY);
+    result = blockingResult;
+  }
+  xSemaphoreGive(blockingMutex);
+  return result;
+}
+
+void StorageTask::OnBlockingDone(void* context, int result) {
+  auto* storage = static_cast<StorageTask*>(context);
+  storage->blockingResult = result;
+  xSemaphoreGive(storage->blockingDone);
+}
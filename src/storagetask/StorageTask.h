@@ -0,0 +1,87 @@
+#pragma once
+
+#include <FreeRTOS.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <queue.h>
+#include <semphr.h>
+#include <task.h>
+#include <littlefs/lfs.h>
+
+namespace Pinetime {
+  namespace Controllers {
+    class FS;
+  }
+
+  namespace System {
+    /** Task that runs filesystem requests in the order they are queued.
+     * Producers like the heart rate logger can queue their writes without waiting for the flash, the data is copied
+     * into the request. Consecutive writes to the same file are done with a single open/close of the file.
+     *
+     * The paths must stay valid until the request is completed (string literals in practice).
+     * The callbacks are called from the storage task: they must be short and must not queue blocking requests. */
+    class StorageTask {
+    public:
+      static constexpr size_t maxDataSize = 16;
+      using Callback = void (*)(void* context, int result);
+
+      explicit StorageTask(Controllers::FS& fs);
+      void Start();
+
+      // Return false if the request could not be queued
+      bool Write(const char* path, uint32_t offset, const void* data, size_t size, Callback callback = nullptr, void* context = nullptr);
+      bool Append(const char* path, const void* data, size_t size, Callback callback = nullptr, void* context = nullptr);
+      bool Delete(const char* path, Callback callback = nullptr, void* context = nullptr);
+      bool CreateDir(const char* path, Callback callback = nullptr, void* context = nullptr);
+      // The buffer must stay valid until the callback is called
+      bool Read(const char* path, uint32_t offset, void* buffer, size_t size, Callback callback, void* context);
+
+      // Wait for the completion of the request, return the number of bytes read or a negative LFS_ERR code
+      int ReadBlocking(const char* path, uint32_t offset, void* buffer, size_t size);
+      int StatBlocking(const char* path, lfs_info* info);
+      // Wait until all the requests queued before are completed
+      void Flush();
+      // Queues FS::Maintenance(), which can keep the filesystem busy for a while
+      bool Maintenance(Callback callback = nullptr, void* context = nullptr);
+
+    private:
+      enum class Operations : uint8_t { Write, Append, Read, Stat, Delete, CreateDir, Flush, Maintenance };
+
+      struct Request {
+        Operations operation;
+        uint16_t size;
+        const char* path;
+        uint32_t offset;
+        void* buffer;
+        Callback callback;
+        void* context;
+        std::array<uint8_t, maxDataSize> data;
+      };
+
+      static constexpr UBaseType_t queueSize = 8;
+      // How long a producer waits for room in the queue before its request is dropped
+      static constexpr TickType_t queueTimeout = pdMS_TO_TICKS(100);
+
+      static void Process(void* instance);
+      void Work();
+      bool Push(const Request& request, TickType_t timeout);
+      int Execute(const Request& request);
+      int OpenForWriting(const char* path);
+      void CloseFile();
+      int Blocking(Request& request);
+      static void OnBlockingDone(void* context, int result);
+
+      Controllers::FS& fs;
+      TaskHandle_t taskHandle = nullptr;
+      QueueHandle_t requestQueue = nullptr;
+      SemaphoreHandle_t blockingMutex;
+      SemaphoreHandle_t blockingDone;
+      int blockingResult = 0;
+
+      // File kept open between consecutive writes to the same path
+      lfs_file_t file;
+      const char* openPath = nullptr;
+    };
+  }
+}
@@ -30,6 +30,9 @@ namespace Pinetime {
       BatteryPercentageUpdated,
       StartFileTransfer,
       StopFileTransfer,
+      AssetImageReceived,
+      ResourcesChanged,
+      FsMaintenanceDone,
       BleRadioEnableToggle
     };
   }
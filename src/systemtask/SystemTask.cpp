@@ -55,7 +55,8 @@ SystemTask::SystemTask(Drivers::SpiMaster& spi,
                        Pinetime::Controllers::FS& fs,
                        Pinetime::Controllers::TouchHandler& touchHandler,
                        Pinetime::Controllers::ButtonHandler& buttonHandler,
-                       Pinetime::Controllers::HeartRateLogger& heartRateLogger)
+                       Pinetime::Controllers::HeartRateLogger& heartRateLogger,
+                       Pinetime::System::StorageTask& storageTask)
   : spi {spi},
     spiNorFlash {spiNorFlash},
     twiMaster {twiMaster},
@@ -79,6 +80,7 @@ SystemTask::SystemTask(Drivers::SpiMaster& spi,
     touchHandler {touchHandler},
     buttonHandler {buttonHandler},
     heartRateLogger {heartRateLogger},
+    storageTask {storageTask},
     nimbleController(*this,
                      bleController,
                      dateTimeController,
@@ -153,6 +155,16 @@ void SystemTask::Work() {
   displayApp.Register(&nimbleController.navigation());
   displayApp.Start(bootError);
 
+  // DisplayApp must be started (its message queue created) before it can be notified of changes
+  batteryController.Subscribe(&displayApp);
+  bleController.Subscribe(&displayApp);
+  heartRateController.Subscribe(&displayApp);
+  motionController.Subscribe(&displayApp);
+  notificationManager.Subscribe(&displayApp);
+  nimbleController.weather().Subscribe(&displayApp);
+  dateTimeController.Subscribe(&displayApp);
+  settingsController.Subscribe(&displayApp);
+
   heartRateSensor.Init();
   heartRateSensor.Disable();
   heartRateApp.Start();
@@ -258,6 +270,7 @@ void SystemTask::Work() {
         case Messages::BleFirmwareUpdateStarted:
           GoToRunning();
           wakeLocksHeld++;
+          nimbleController.connectionParameters().Acquire(Controllers::ConnectionParametersManager::Workloads::FirmwareUpdate);
           displayApp.PushMessage(Pinetime::Applications::Display::Messages::BleFirmwareUpdateStarted);
           break;
         case Messages::BleFirmwareUpdateFinished:
@@ -265,18 +278,43 @@ void SystemTask::Work() {
             NVIC_SystemReset();
           }
           wakeLocksHeld--;
+          nimbleController.connectionParameters().Release(Controllers::ConnectionParametersManager::Workloads::FirmwareUpdate);
           break;
         case Messages::StartFileTransfer:
           NRF_LOG_INFO("[systemtask] FS Started");
           GoToRunning();
           wakeLocksHeld++;
+          nimbleController.connectionParameters().Acquire(Controllers::ConnectionParametersManager::Workloads::FileTransfer);
           // TODO add intent of fs access icon or something
           break;
         case Messages::StopFileTransfer:
           NRF_LOG_INFO("[systemtask] FS Stopped");
           wakeLocksHeld--;
+          nimbleController.connectionParameters().Release(Controllers::ConnectionParametersManager::Workloads::FileTransfer);
           // TODO add intent of fs access icon or something
           break;
+        case Messages::AssetImageReceived:
+          fs.InstallAssets();
+          fs.VerifyResource();
+          displayApp.PushMessage(Pinetime::Applications::Display::Messages::ResourcesChanged);
+          break;
+        case Messages::ResourcesChanged:
+          fs.VerifyResource();
+          displayApp.PushMessage(Pinetime::Applications::Display::Messages::ResourcesChanged);
+          break;
+        case Messages::FsMaintenanceDone:
+          fsMaintenanceRunning = false;
+          // Writes queued while the maintenance was running
+          storageTask.Flush();
+          // The flash and the SPI were not put to sleep with the rest of the peripherals
+          if ((state == SystemTaskState::Sleeping || state == SystemTaskState::AODSleeping) && BootloaderVersion::IsValid()) {
+            spiNorFlash.Sleep();
+          }
+          if (state == SystemTaskState::Sleeping && !spiSleeping) {
+            spi.Sleep();
+            spiSleeping = true;
+          }
+          break;
         case Messages::OnTouchEvent:
           // Finish immediately if no new events
           if (!touchHandler.ProcessTouchInfo(touchPanel.GetTouchInfo())) {
@@ -325,15 +363,16 @@ void SystemTask::Work() {
           if (state != SystemTaskState::GoingToSleep) {
             break;
           }
-          if (BootloaderVersion::IsValid()) {
+          if (BootloaderVersion::IsValid() && !fsMaintenanceRunning) {
             // First versions of the bootloader do not expose their version and cannot initialize the SPI NOR FLASH
             // if it's in sleep mode. Avoid bricked device by disabling sleep mode on these versions.
             spiNorFlash.Sleep();
           }
 
-          // Must keep SPI awake when still updating the display for always on
-          if (msg == Messages::OnDisplayTaskSleeping) {
+          // Must keep SPI awake when still updating the display for always on, or when the storage task uses the flash
+          if (msg == Messages::OnDisplayTaskSleeping && !fsMaintenanceRunning) {
             spi.Sleep();
+            spiSleeping = true;
           }
 
           // Double Tap needs the touch screen to be in normal mode
@@ -421,9 +460,10 @@ void SystemTask::GoToRunning() {
     return;
   }
   if (state == SystemTaskState::Sleeping || state == SystemTaskState::AODSleeping) {
-    // SPI only switched off when entering Sleeping, not AOD or GoingToSleep
-    if (state == SystemTaskState::Sleeping) {
+    // SPI only switched off when entering Sleeping, not AOD or GoingToSleep, and not during the FS maintenance
+    if (spiSleeping) {
       spi.Wakeup();
+      spiSleeping = false;
     }
 
     // Double Tap needs the touch screen to be in normal mode
@@ -452,16 +492,44 @@ void SystemTask::GoToSleep() {
     return;
   }
   NRF_LOG_INFO("[systemtask] Going to sleep");
+  // Write the settings that were changed but not saved yet
+  settingsController.SaveSettings();
+  heartRateLogger.Flush();
+  // The flash is put to sleep once the display is off, the writes must be done by then. During the maintenance, they
+  // are queued behind it and waited for when it is done.
+  if (!fsMaintenanceRunning) {
+    storageTask.Flush();
+  }
   if (settingsController.GetAlwaysOnDisplay()) {
     displayApp.PushMessage(Pinetime::Applications::Display::Messages::GoToAOD);
   } else {
     displayApp.PushMessage(Pinetime::Applications::Display::Messages::GoToSleep);
   }
   heartRateApp.PushMessage(Pinetime::Applications::HeartRateTask::Messages::GoToSleep);
+  StartFsMaintenance();
 
   state = SystemTaskState::GoingToSleep;
 };
 
+void SystemTask::StartFsMaintenance() {
+  if (fsMaintenanceRunning || !batteryController.IsPowerPresent()) {
+    return;
+  }
+  if (fsMaintenanceDone && xTaskGetTickCount() - lastFsMaintenance < fsMaintenancePeriod) {
+    return;
+  }
+  // Queued after the writes of GoToSleep()
+  if (storageTask.Maintenance(OnFsMaintenanceDone, this)) {
+    fsMaintenanceRunning = true;
+    fsMaintenanceDone = true;
+    lastFsMaintenance = xTaskGetTickCount();
+  }
+}
+
+void SystemTask::OnFsMaintenanceDone(void* context, int /*result*/) {
+  static_cast<SystemTask*>(context)->PushMessage(Messages::FsMaintenanceDone);
+}
+
 void SystemTask::UpdateMotion() {
   // Unconditionally update motion
   // Reading steps/motion characteristics must return up to date information even when not subscribed to notifications
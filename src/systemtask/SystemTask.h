@@ -20,6 +20,7 @@
 #include "components/alarm/SmartAlarmController.h"
 #include "components/heartrate/HeartRateLogger.h"
 #include "components/fs/FS.h"
+#include "storagetask/StorageTask.h"
 #include "touchhandler/TouchHandler.h"
 #include "buttonhandler/ButtonHandler.h"
 #include "buttonhandler/ButtonActions.h"
@@ -78,7 +79,8 @@ namespace Pinetime {
                  Pinetime::Controllers::FS& fs,
                  Pinetime::Controllers::TouchHandler& touchHandler,
                  Pinetime::Controllers::ButtonHandler& buttonHandler,
-                 Pinetime::Controllers::HeartRateLogger& heartRateLogger);
+                 Pinetime::Controllers::HeartRateLogger& heartRateLogger,
+                 Pinetime::System::StorageTask& storageTask);
 
       void Start();
       void PushMessage(Messages msg);
@@ -132,6 +134,7 @@ namespace Pinetime {
       Pinetime::Controllers::TouchHandler& touchHandler;
       Pinetime::Controllers::ButtonHandler& buttonHandler;
       Pinetime::Controllers::HeartRateLogger& heartRateLogger;
+      Pinetime::System::StorageTask& storageTask;
       Pinetime::Controllers::NimbleController nimbleController;
 
       static void Process(void* instance);
@@ -150,6 +153,16 @@ namespace Pinetime {
       void UpdateMotion();
       static constexpr TickType_t batteryMeasurementPeriod = pdMS_TO_TICKS(10 * 60 * 1000);
 
+      // The filesystem maintenance runs when the watch goes to sleep on its charger, at most once per period.
+      // The external flash and the SPI are kept awake until it is done.
+      void StartFsMaintenance();
+      static void OnFsMaintenanceDone(void* context, int result);
+      static constexpr TickType_t fsMaintenancePeriod = pdMS_TO_TICKS(60 * 60 * 1000);
+      bool fsMaintenanceRunning = false;
+      bool fsMaintenanceDone = false;
+      TickType_t lastFsMaintenance = 0;
+      bool spiSleeping = false;
+
       SystemMonitor monitor;
     };
   }
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+
+namespace Pinetime {
+  namespace Utility {
+    enum class DataSource : uint8_t { Battery, Ble, HeartRate, Motion, Notifications, Weather, Time, Count };
+    using DataSources = std::bitset<static_cast<size_t>(DataSource::Count)>;
+
+    class DataChangeListener {
+    public:
+      // Called from the task (or interrupt handler) that modified the data.
+      // Implementations must only record the change and defer the actual work to their own task.
+      virtual void OnDataChanged(DataSource source) = 0;
+
+    protected:
+      ~DataChangeListener() = default;
+    };
+
+    // Lets a controller tell a single listener (usually DisplayApp) that one of its values changed,
+    // so that screens don't have to poll the controller to find out.
+    class DataChangeNotifier {
+    public:
+      explicit DataChangeNotifier(DataSource source) : source {source} {
+      }
+
+      void Subscribe(DataChangeListener* listener) {
+        this->listener = listener;
+      }
+
+      void Notify() const {
+        if (listener != nullptr) {
+          listener->OnDataChanged(source);
+        }
+      }
+
+    private:
+      const DataSource source;
+      DataChangeListener* listener = nullptr;
+    };
+  }
+}
@@ -18,6 +18,11 @@ namespace Pinetime {
         return false;
       }
 
+      // Reports the value as updated even if it did not change
+      void Invalidate() {
+        this->isUpdated = true;
+      }
+
       T const& Get() {
         this->isUpdated = false;
         return value;